@@ -7,11 +7,33 @@
 #include <vector>
 #include <set>
 #include <cmath>
+#include <thread>
+#include <exception>
+#include <future>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <fstream>
+#include <mutex>
+#include <algorithm>
+#include <cctype>
+
+#include "bounded_queue.hpp"
+#include "change_filter.hpp"
+#include "colour_signature.hpp"
+#include "frame_sampler.hpp"
+#include "hash_index.hpp"
+#include "hash_region.hpp"
+#include "keyframe_index.hpp"
+#include "phash.hpp"
+#include "raw_frame_reader.hpp"
+#include "slide_index.hpp"
+#include "tile_hash.hpp"
+#include "transition_refiner.hpp"
 
 using namespace std;
 using namespace cv;
 namespace fs = std::filesystem;
-// TODO: Ӧ֡
 
 /**
  * @brief ʽΪ HH:MM:SS ַʽ
@@ -39,9 +61,10 @@ public:
  * @param progress_interval ȱmin
  * @param start ȡʼ֡
  * @param end ȡ֡
+ * @param verbose Ƿʱرգ
  */
-    ProgressReporter(double total_duration, int fps, int progress_interval, int start, int end)
-        : total_duration(total_duration), fps(fps), progress_interval(progress_interval), start(start), end(end) {
+    ProgressReporter(double total_duration, double fps, int progress_interval, int start, int end, bool verbose = true)
+        : total_duration(total_duration), fps(fps), progress_interval(progress_interval), start(start), end(end), verbose(verbose) {
         
         start_time = chrono::high_resolution_clock::now();
         // Ҫʱ
@@ -57,7 +80,7 @@ public:
  * @param frame_count ѾȡͼЧģ
  */
     void report_progress(double elapsed_time, int frame_count) {
-        if (!report_times.empty() && elapsed_time >= report_times.front()) {
+        if (verbose && !report_times.empty() && elapsed_time >= report_times.front()) {
             auto now = chrono::high_resolution_clock::now();
             chrono::duration<double> processed_time = now - start_time;
             double percent = (elapsed_time * fps - start) / (end - start) * 100;
@@ -68,7 +91,23 @@ public:
         }
     }
 
+/**
+ * @brief ٷֱȼƵĽȣֶβʱʹãʱв֪ȡͼƬ
+ * 
+ * @param percent Ѵİٷֱ
+ */
+    void report_percent(double percent) {
+        if (!verbose) return;
+        auto now = chrono::high_resolution_clock::now();
+        chrono::duration<double> processed_time = now - start_time;
+        cout << "\r" << std::string(80, ' '); // ǰ
+        cout << "\rѴ " << percent << " % Ƶݣѻʱ䣺" << time_format(processed_time.count()) << flush;
+    }
+
+    double frame_rate() const { return fps; }
+
     void report_result(int frame_count) {
+        if (!verbose) return;
         auto now = chrono::high_resolution_clock::now();
         chrono::duration<double> total_time = now - start_time;
         cout << "\nʱ" << time_format(total_time.count()) << "ͼƬ" << frame_count << endl;
@@ -76,10 +115,11 @@ public:
 
 private:
     const double total_duration;  // ʱ
-    const int fps;                // ֡
+    const double fps;             // ֡
     const int progress_interval;   // ȱ
     const int start;              // ȡʼ֡
     const int end;                // ȡ֡
+    const bool verbose;           // Ƿ
     chrono::time_point<chrono::high_resolution_clock> start_time; // ʼʱ
     vector<double> report_times; // 洢бʱ
 };
@@ -87,124 +127,747 @@ private:
 /**
  * @brief ͼĸ֪ϣֵ
  * 
- * @param img ͼ
- * @return size_t õĹϣֵ
+ * @param img ͼ񣨽
+ * @param layout Ų
+ * @param region ϣĻ
+ * @param hasher ͼϣĺ
+ * @param colour Ƿڹϣ֮󸽼ɫǩ
+ * @param hash_bits ϣλɫǩڵ
+ * @return FrameHash õĹϣֵ
+ */
+FrameHash calculate_hash(const Mat& img, PixelLayout layout, const HashRegion& region, HashFunction hasher,
+                         bool colour = false, int hash_bits = 64) {
+    // ƽСΪ32x32ҶͼתҶСһζȡɣɫͼͬһСеõ
+    float thumbnail[thumbnail_size * thumbnail_size];
+    float chroma[thumbnail_size * thumbnail_size];
+    region.make_thumbnail(img, layout, thumbnail, colour ? chroma : nullptr);
+
+    // 㷨ͬһͼpHashֻϽ8x8DCTϵ
+    FrameHash hash = hasher(thumbnail);
+    if (colour) add_colour_signature(hash, hash_bits, chroma);
+    return hash;
+}
+
+// ȡ
+struct ExtractOptions {
+    int start = 0;              // ʼʱ䣨min<=0 ʾͷʼ
+    int end = -1;               // ʱ䣨min<=0 ʾβ
+    int frame_skip = 30;        // ֡
+    int progress_interval = 5;  // ʾʱ䣨min
+    int threshold = 4;          // ƶȱȽֵ
+    bool sequential = true;     // Ƿ˳루ֻλһΣ֮֡֡GOPʱʹöλ
+    int queue_depth = 8;        // ȣ֡Ԥռõڴ
+    int segments = 1;           // зֶ1ʱÿʹö VideoCapture ߳
+    bool build_index = false;   // ûлĹؼ֡ʱǷȽ̽
+    bool luma_only = true;      // ǷYUVֻƽϣ
+    int max_skip = 0;           // Ӧ֡֡ frame_skip ʱ
+    bool refine = false;        // ڲ֡ʱǷֶλҳλ
+    bool time_based = false;    // Ƿʾʱڷ֡ʺͿɱ֡ʣ
+    bool verbose = true;        // ǷȵʾϢ
+    string raw_format;          // ܵΪrawvideoʱĸʽ "x:ظʽ[:֡]"ΪʱY4M
+    HashKind hash_kind = HashKind::PHash; // ֪ϣ㷨
+    int hash_bits = 64;         // ϣλ64128  256
+    Rect roi;                   // ϣĻΪʱʹ
+    vector<Rect> exclusions;    // ϣʱųĻ򣨻лʱӵȣ
+    string mask_file;           // ͼ·ɫֲϣΪʱʹ
+    int tile_rows = 0;          // ָϣ0ʱãֵȽ
+    int tile_cols = 0;          // ָϣ
+    int sad_floor = 0;          // Ԥɸޣ169ͼĸҶȼ0 ʾ
+    bool colour = false;        // Ƿ񸽼ɫǩֻıɫһУĻҲΪµһҳ
+    string index_file;          // ƵõĹϣļеĻֻ references.csvΪʱʹ
+};
+
+// ֡Ĺϣ㣺ϣϣĻ÷ָʱΪָϣ
+struct FrameHasher {
+    HashFunction function;
+    HashRegion region;
+    TileHasher tiles;
+    HashDistance distance; // ϣ룬ֻȽϹϣռõ
+    int hash_bits = 64;    // ϣλ
+    bool colour = false;   // Ƿ񸽼ɫǩָϣͬʱʹã
+    vector<int> words;     // ϣռõ64λ֣ѱϣ
+
+    FrameHash operator()(const SampledFrame& sample) const {
+        if (!tiles.empty()) return tiles.hash(sample.frame, sample.layout);
+        return calculate_hash(sample.frame, sample.layout, region, function, colour, hash_bits);
+    }
+};
+
+// ȡùϣĸʽ롢ɫǩռõ֣뻭ߴ޹
+void set_hash_format(const ExtractOptions& options, FrameHasher& hasher) {
+    bool tiled = options.tile_rows > 0 && options.tile_cols > 0;
+    hasher.hash_bits = options.hash_bits;
+    // ɫǩռùϣ֮һ
+    hasher.colour = options.colour && !tiled && colour_word(options.hash_bits) < frame_hash_words;
+    hasher.words.clear();
+    for (int i = 0; i < options.hash_bits / 64; ++i) hasher.words.push_back(i);
+    if (hasher.colour) hasher.words.push_back(colour_word(options.hash_bits));
+    // 64λϣֻźͱȽһ֣ɫǩʱ
+    hasher.distance = tiled ? HashDistance::tiles() : HashDistance::hamming(int(hasher.words.size()));
+}
+
+/**
+ * @brief ȡ֡Ĺϣ㡣
+ * 
+ * @param options ȡ
+ * @param frame_size ߴ
+ * @param hasher 
+ * @return bool ͼ޷ȡʱ false
+ */
+bool make_frame_hasher(const ExtractOptions& options, Size frame_size, FrameHasher& hasher) {
+    Mat mask;
+    if (!options.mask_file.empty()) {
+        mask = imread(options.mask_file, IMREAD_GRAYSCALE);
+        if (mask.empty()) {
+            cerr << "޷ȡͼ" << options.mask_file << endl;
+            return false;
+        }
+    }
+    hasher.function = hash_function(options.hash_kind, options.hash_bits);
+    hasher.region = HashRegion(frame_size, options.roi, options.exclusions, mask);
+    if (options.tile_rows > 0 && options.tile_cols > 0) {
+        hasher.tiles = TileHasher(frame_size, options.roi, options.exclusions, mask, options.tile_rows, options.tile_cols);
+    }
+    set_hash_format(options, hasher);
+    if (options.colour && !hasher.colour) {
+        cerr << "ɫǩֻ벻128λĹϣһʹãҲڷָϣβȽɫ" << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief ȡָĹϣ
+ *
+ * ƵãڴһƵ֮ǰһΣйϣĸʽֻȡ뻭ߴ޹ء
+ *
+ * @param options ȡindex_file Ϊգ
+ * @param slides 򿪽
+ * @return bool Ƿɹ
+ */
+bool open_slide_index(const ExtractOptions& options, SlideIndex& slides) {
+    FrameHasher hasher;
+    set_hash_format(options, hasher);
+    IndexFormat format;
+    format.hash_kind = uint32_t(options.hash_kind);
+    format.hash_bits = uint32_t(options.hash_bits);
+    if (hasher.distance.tiled) {
+        format.tile_rows = uint32_t(options.tile_rows);
+        format.tile_cols = uint32_t(options.tile_cols);
+    }
+    format.colour = hasher.colour ? colour_format : 0;
+    string error;
+    if (!slides.open(options.index_file, format, hasher.distance, hasher.words, error)) {
+        cerr << error << endl;
+        return false;
+    }
+    cout << "ϣ" << options.index_file << "ѱ " << slides.size() << " ͼƬ" << endl;
+    return true;
+}
+
+// ϣ··ʱĹĿ¼޹أ
+string index_path(const string& path) {
+    if (path == "-") return path;
+    error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    return ec ? path : absolute.lexically_normal().string();
+}
+
+/**
+ * @brief ΪӦ֡
+ *
+ * ϣڽ߳һ㲢дڲ֡Ĺϣһ
+ * 
+ * @param sampler FrameSampler  RawFrameSampler
+ * @param options ȡ
+ * @param hasher ֡Ĺϣ
+ */
+template <typename Sampler>
+void enable_adaptive_skip(Sampler& sampler, const ExtractOptions& options, const FrameHasher& hasher) {
+    if (options.max_skip <= options.frame_skip) return;
+    AdaptiveSkip controller(options.frame_skip, options.max_skip, options.threshold);
+    sampler.set_step_controller([controller, hasher, prev_hash = FrameHash(), first = true](SampledFrame& sample) mutable {
+        sample.hash = hasher(sample);
+        sample.hashed = true;
+        int step = controller.update(first ? -1 : hasher.distance(prev_hash, sample.hash));
+        prev_hash = sample.hash;
+        first = false;
+        return step;
+    });
+}
+
+/**
+ * @brief 贴ҳλϸ
+ * 
+ * @param cap õƵ
+ * @param options ȡ
+ * @param fps ֡
+ * @param hasher ֡Ĺϣ
+ * @return unique_ptr<TransitionRefiner> δʱΪ
+ */
+unique_ptr<TransitionRefiner> make_refiner(VideoCapture& cap, const ExtractOptions& options, double fps,
+                                           const FrameHasher& hasher) {
+    if (!options.refine) return nullptr;
+    // 汣0.2s伴Ϊȶлм״̬һҳ
+    return make_unique<TransitionRefiner>(cap, hasher, hasher.distance, options.threshold, int(fps / 5));
+}
+
+// ͼƬ·
+string frame_file_path(const string& output_folder, double elapsed_time, int frame_count) {
+    return output_folder + "/frame_" + to_string(int(elapsed_time / 60)) + "min_" + to_string(frame_count) + ".jpg";
+}
+
+// ʾʱ䣬 "00:12:34.567"
+string time_format_msec(double msec) {
+    char millis[8];
+    snprintf(millis, sizeof(millis), ".%03d", int(fmod(msec, 1000.0)));
+    return time_format(msec / 1000) + millis;
+}
+
+/**
+ * @brief ʱ¼׷һͼƬʵʾʱ䡣
+ * 
+ * @param timestamps ¼ļtimestamps.csv
+ * @param frame_path ͼƬ·
+ * @param msec ʾʱms
+ */
+void record_timestamp(ostream& timestamps, const string& frame_path, double msec) {
+    timestamps << fs::path(frame_path).filename().string() << "," << time_format_msec(msec) << "," << msec << "\n";
+}
+
+// CSVеһֶΣšŻʱ
+string csv_field(const string& value) {
+    if (value.find_first_of(",\"\r\n") == string::npos) return value;
+    string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * @brief ü¼׷һĻ棺ϣƵĻ棨Ƶ֮ǰУ
+ *
+ * @param references ¼ļreferences.csv
+ * @param msec Ƶеʾʱms
+ * @param existing ѱĻ
  */
-size_t calculate_pHash(const Mat& img) {
-    // ͼС
-    Mat resized;
-    resize(img, resized, Size(32, 32)); // Ϊ32x32
-
-    // תΪҶͼ
-    Mat gray;
-    cvtColor(resized, gray, COLOR_BGR2GRAY);
-
-    // DCTҪ͵ģڴתһ
-    Mat gray_float;
-    gray.convertTo(gray_float, CV_64F);
-
-    // DCT
-    Mat dct_result;
-    dct(gray_float, dct_result);
-    
-    // ȡϽ8x8DCTϵ
-    Mat dct_roi = dct_result(Rect(0, 0, 8, 8));
-
-    // ƽֵ
-    double mean = cv::mean(dct_roi)[0];
-    
-    // ɹϣֵ
-    size_t hash = 0;
-    for (int i = 0; i < dct_roi.rows; ++i) {
-        for (int j = 0; j < dct_roi.cols; ++j) {
-            // DCTϵƽֵöӦλΪ1
-            hash <<= 1;
-            if (dct_roi.at<double>(i, j) > mean) {
-                hash |= 1;
+void record_reference(ostream& references, double msec, const IndexEntry& existing) {
+    references << time_format_msec(msec) << "," << msec << "," << csv_field(existing.source) << ","
+               << time_format_msec(existing.timestamp) << "," << csv_field(existing.output_path) << "\n";
+}
+
+/**
+ * @brief ȡʱȥ뱣棺ѱ֡ȽϣʱתΪBGR棬ͬʱ¼ʱ
+ *
+ * һͨԤɸĲ֡δ仯ʱֱϣҲѱ֡Ƚϡ
+ * ʹùõĹϣʱƻ棨Ƶ֮ǰУ֡ٱ棬ֻ references.csv
+ * ֡׷ӵС
+ */
+class FrameKeeper {
+public:
+    FrameKeeper(const string& output_folder, int threshold, const FrameHasher& hasher, int sad_floor,
+                const string& input_file, SlideIndex* slides)
+        : output_folder(output_folder), threshold(threshold), hasher(hasher), filter(sad_floor, hasher.region.area(), hasher.region.tiny_exclusions()),
+          timestamps(output_folder + "/timestamps.csv"), kept_hashes(hasher.distance, hasher.words),
+          source(index_path(input_file)), slides(slides) {
+        if (slides) references.open(output_folder + "/references.csv");
+    }
+
+/**
+ * @brief һ֡
+ * 
+ * @param sample ֡δϣʱڴ˼㣩
+ * @return bool Ƿ񱻱
+ */
+    bool offer(const SampledFrame& sample) {
+        if (filter.unchanged(sample.frame, sample.layout)) return false;
+        FrameHash img_hash = sample.hash;
+        if (!sample.hashed) img_hash = hasher(sample);
+        // TODO: õļ㷨
+        if (kept_hashes.contains_within(img_hash, threshold)) return false;
+        IndexEntry existing;
+        SlideClaim claim; // תдʱ׳쳣ҲǼ
+        if (slides && slides->find_or_claim(img_hash, threshold, existing, claim)) {
+            kept_hashes.insert(img_hash);
+            record_reference(references, sample.timestamp, existing);
+            reference_count++;
+            return false;
+        }
+
+        string frame_path = frame_file_path(output_folder, sample.timestamp / 1000, frame_count);
+        to_bgr(sample.frame, sample.layout, bgr); // ֻҪ֡תΪBGR
+        bool saved = imwrite(frame_path, bgr);
+        // дɹż¼ʱ͹ϣе·ָеļ
+        claim.commit(saved, source, sample.timestamp, index_path(frame_path));
+        if (!saved) {
+            cerr << "޷ͼƬ" << frame_path << endl;
+            return false;
+        }
+        record_timestamp(timestamps, frame_path, sample.timestamp);
+        kept_hashes.insert(img_hash);
+        frame_count++;
+        return true;
+    }
+
+    // ѾȡͼЧģ
+    int count() const { return frame_count; }
+
+    // ԤɸĲ֡
+    int unchanged_count() const { return filter.skipped_count(); }
+
+    // ϣСֻõ֡
+    int referenced_count() const { return reference_count; }
+
+private:
+    const string output_folder;  // ļ
+    const int threshold;         // ƶȱȽֵ
+    const FrameHasher hasher;    // ϣ
+    ChangeFilter filter;         // Ԥɸ
+    ofstream timestamps;         // ¼ÿͼƬʵʾʱ
+    HashIndex kept_hashes;       // ѱֻãĹϣֵ
+    const string source;         // ϣԴƵ
+    SlideIndex* slides;          // ƵõĹϣΪ
+    ofstream references;         // ¼еĻ棨ʹùϣʱ
+    int frame_count = 0;         // Ѿȡͼ
+    int reference_count = 0;     // ֻõ֡
+    Mat bgr;                     // õBGR
+};
+
+// ֶβʱһ֡Ľ
+struct SampleHash {
+    int frame_index;  // ֡
+    double position;  // ȡ CAP_PROP_POS_FRAMES
+    double timestamp; // ʾʱms
+    FrameHash hash;   // ֪ϣֵ
+};
+
+/**
+ * @brief һƵв֡ĹϣֵֶβеḶ́߳
+ * 
+ * @param input_file Ƶļ·
+ * @param seg_start ʼ֡
+ * @param seg_limit β֡ޣ
+ * @param end_frame ֡
+ * @param options ȡ
+ * @param hasher ֡Ĺϣ
+ * @param gop_length GOPȣ֡
+ * @param keyframes ؼ֡Ϊ
+ * @param processed Ѵ֡ڽȱ
+ * @return vector<SampleHash> ˳еĲ
+ */
+vector<SampleHash> hash_segment(const string& input_file, int seg_start, int seg_limit, int end_frame,
+                                const ExtractOptions& options, const FrameHasher& hasher, double gop_length,
+                                const KeyframeIndex* keyframes, atomic<int>& processed) {
+    const int batch_size = 16; // ϣ֡
+    vector<SampleHash> result;
+    // ԤɸжΪδ仯Ĳ֡ʽ޲֤ϣƣ
+    ChangeFilter filter(options.sad_floor, hasher.region.area(), hasher.region.tiny_exclusions());
+    VideoCapture cap(input_file);
+    if (!cap.isOpened()) return result;
+
+    double fps = cap.get(CAP_PROP_FPS);
+    FrameSampler sampler(cap, seg_start, end_frame, options.frame_skip, options.sequential, gop_length, seg_limit);
+    sampler.set_keyframe_index(keyframes);
+    if (options.time_based) sampler.set_time_schedule(seg_start * 1000 / fps, options.end * 60000.0, 1000 / fps);
+    if (options.luma_only) sampler.request_raw_yuv();
+    enable_adaptive_skip(sampler, options, hasher);
+    auto refiner = make_refiner(cap, options, fps, hasher);
+    // δϣĲֻ֡ͼܹһһ
+    ThumbnailBatch batch(batch_size);
+    vector<size_t> pending; // ȴϣĽ
+    FrameHash hashes[batch_size];
+    uint64_t colours[batch_size]; // ȴĸ֡ɫǩ
+    float thumbnail[thumbnail_size * thumbnail_size];
+    float chroma[thumbnail_size * thumbnail_size];
+    auto flush = [&] {
+        hash_batch(batch, options.hash_kind, options.hash_bits, hashes);
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (hasher.colour) hashes[i].words[colour_word(options.hash_bits)] = colours[i];
+            result[pending[i]].hash = hashes[i];
+        }
+        batch.clear();
+        pending.clear();
+    };
+
+    SampledFrame sample;
+    vector<SampledFrame> refined;
+    int last_index = seg_start;
+    while (sampler.next(sample)) {
+        processed += sample.frame_index - last_index;
+        last_index = sample.frame_index;
+
+        refined.clear();
+        if (refiner) {
+            refiner->refine(std::move(sample), refined);
+        } else {
+            refined.push_back(std::move(sample));
+        }
+        for (const auto& item : refined) {
+            if (filter.unchanged(item.frame, item.layout)) continue;
+            result.push_back({item.frame_index, item.position, item.timestamp, item.hash});
+            if (!item.hashed && !hasher.tiles.empty()) {
+                result.back().hash = hasher(item); // ָϣѲм㣬
+            } else if (!item.hashed) {
+                hasher.region.make_thumbnail(item.frame, item.layout, thumbnail, hasher.colour ? chroma : nullptr);
+                if (hasher.colour) colours[pending.size()] = colour_signature(chroma);
+                pending.push_back(result.size() - 1);
+                batch.add(thumbnail);
+                if (batch.full()) flush();
             }
         }
+        sample = SampledFrame();
     }
-    
-    return hash;
+    flush();
+    return result;
+}
+
+// ֶβʱһĲ֡
+struct KeptFrame {
+    SampleHash sample;       // 
+    string pending_path;     // ½ݴͼƬ·
+    bool written = false;    // Ƿݴ
+    bool referenced = false; // ϣУֻ
+    IndexEntry existing;     // еĻ
+};
+
+/**
+ * @brief ½һڱ֡ݴΪͼƬֶβе׶Σ
+ *
+ * 봮ͬYUV to_bgr תͼƬ봮һ¡
+ * ĳһ֡޷дʱ֡ÿ֡Ƿݴɹ written С
+ * 
+ * @param input_file Ƶļ·
+ * @param output_folder ļ·
+ * @param segment ţݴ·
+ * @param kept αĲ֡
+ * @param luma_only ǷYUV
+ * @return int ޷ݴ֡
+ */
+int write_segment_frames(const string& input_file, const string& output_folder, int segment, vector<KeptFrame>& kept,
+                         bool luma_only) {
+    VideoCapture cap(input_file);
+    FrameRetriever retriever(cap);
+    if (cap.isOpened() && luma_only) retriever.request_raw_yuv();
+    Mat frame, bgr;
+    int failed = 0, pending = 0;
+    for (auto& item : kept) {
+        if (item.referenced) continue;
+        item.pending_path = output_folder + "/pending_" + to_string(segment) + "_" + to_string(pending++) + ".jpg";
+        cap.set(CAP_PROP_POS_FRAMES, item.sample.frame_index);
+        if (cap.isOpened() && cap.grab() && retriever.retrieve(frame)) {
+            to_bgr(frame, retriever.pixel_layout(), bgr);
+            item.written = imwrite(item.pending_path, bgr);
+        }
+        if (!item.written) failed++;
+    }
+    return failed;
+}
+
+/**
+ * @brief ֶβȡ
+ *
+ * ΧзΪɶΣйؼ֡ʱα߽뵽ؼ֡ɶ VideoCapture ̼߳ϣУ
+ * ˳ȫϣӦ봮ͬȥعɸβе½뱻֡ݴ棬
+ * ˳Ϊݴɹ֡šΪ·ɹϣ¼ʱ봮һ
+ *
+ * 봮лһ£в
+ * - Ӧ֡ʱζ֡봮вͬ
+ * - ԤɸͷҳϸڸڶУÿοͷûв֡α߽總ܶౣٱһ֡
+ *
+ * @return int ͼƬ
+ */
+int extract_frames_parallel(const string& input_file, const string& output_folder, const ExtractOptions& options,
+                             const FrameHasher& hasher, int start_frame, int end_frame, double gop_length, const KeyframeIndex* keyframes,
+                             SlideIndex* slides, ProgressReporter& progress_reporter) {
+    int frame_skip = max(1, options.frame_skip);
+    int segments = options.segments;
+
+    // α߽磺Ȱ֣ٶ뵽֮ǰĹؼ֡ʹεĽ뻥ص
+    vector<int> bounds;
+    int grid_points = (end_frame - start_frame + frame_skip - 1) / frame_skip;
+    for (int i = 0; i < segments; ++i) {
+        int bound = start_frame + int(int64_t(grid_points) * i / segments) * frame_skip;
+        if (i > 0 && keyframes && keyframes->usable()) {
+            bound = max(bounds.back(), keyframes->keyframe_at_or_before(bound));
+        }
+        bounds.push_back(bound);
+    }
+    bounds.push_back(numeric_limits<int>::max()); // һ봮һ end_frame ֹ
+
+    // һ׶Σβмϣÿδӱ߽֮ĵһ㿪ʼ֤֡봮һ
+    atomic<int> processed(0);
+    vector<future<vector<SampleHash>>> workers;
+    for (int i = 0; i < segments; ++i) {
+        int seg_start = start_frame + (bounds[i] - start_frame + frame_skip - 1) / frame_skip * frame_skip;
+        workers.push_back(async(launch::async, hash_segment, cref(input_file), seg_start, bounds[i + 1], end_frame,
+                                cref(options), cref(hasher), gop_length, keyframes, ref(processed)));
+    }
+    for (auto& worker : workers) {
+        while (worker.wait_for(chrono::seconds(1)) != future_status::ready) {
+            progress_reporter.report_percent(100.0 * processed / (end_frame - start_frame));
+        }
+    }
+
+    // ڶ׶Σ˳ϲȥع봮ͬ
+    HashIndex kept_hashes(hasher.distance, hasher.words);
+    vector<vector<KeptFrame>> kept(segments);
+    for (int i = 0; i < segments; ++i) {
+        for (const auto& sample : workers[i].get()) {
+            if (kept_hashes.contains_within(sample.hash, options.threshold)) continue;
+            kept_hashes.insert(sample.hash);
+            KeptFrame item;
+            item.sample = sample;
+            // еĲ½룻ڸǰٵǼ
+            item.referenced = slides && slides->find(sample.hash, options.threshold, item.existing);
+            kept[i].push_back(item);
+        }
+    }
+
+    // ׶Σβ½뱻֡ݴ
+    vector<future<int>> writers;
+    for (int i = 0; i < segments; ++i) {
+        writers.push_back(async(launch::async, write_segment_frames, cref(input_file), cref(output_folder), i, ref(kept[i]),
+                                options.luma_only));
+    }
+    int failed = 0;
+    for (auto& writer : writers) failed += writer.get();
+
+    // Ľ׶Σ˳Ϊݴɹ֡Ųʱ͹ϣе·ָеļ
+    ofstream timestamps(output_folder + "/timestamps.csv");
+    ofstream references;
+    if (slides) references.open(output_folder + "/references.csv");
+    string source = index_path(input_file);
+    int frame_count = 0, reference_count = 0;
+    for (auto& segment : kept) {
+        for (auto& item : segment) {
+            error_code ec;
+            SlideClaim claim; // ͬʱеƵܸձͬһ棬ǰٵǼ
+            if (item.written && slides && slides->find_or_claim(item.sample.hash, options.threshold, item.existing, claim)) {
+                fs::remove(item.pending_path, ec);
+                item.referenced = true;
+            }
+            if (item.referenced) {
+                record_reference(references, item.sample.timestamp, item.existing);
+                reference_count++;
+                continue;
+            }
+            if (!item.written) continue;
+            string frame_path = frame_file_path(output_folder, item.sample.timestamp / 1000, frame_count);
+            fs::remove(frame_path, ec); // ֮ǰе imwrite һ
+            fs::rename(item.pending_path, frame_path, ec);
+            claim.commit(!ec, source, item.sample.timestamp, index_path(frame_path));
+            if (ec) {
+                fs::remove(item.pending_path, ec);
+                failed++;
+                continue;
+            }
+            record_timestamp(timestamps, frame_path, item.sample.timestamp);
+            frame_count++;
+        }
+    }
+    if (failed > 0) cerr << failed << " ͼƬ޷½򱣴棺" << input_file << endl;
+    if (options.verbose && slides) cout << "ϣ " << reference_count << " ţֻ references.csv" << endl;
+
+    progress_reporter.report_result(frame_count);
+    return frame_count;
+}
+
+// Сдչ㣩
+string extension_of(const fs::path& path) {
+    string ext = path.extension().string();
+    transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(tolower(c)); });
+    return ext;
+}
+
+/**
+ * @brief ǷֱӶȡδѹ֡׼롢ܵ.y4m ļԼָ --raw_format ʱ .yuv/.raw ļ
+ *
+ * ļmp4 ʹָ --raw_format Ҳ VideoCapture 룬ʱԻ롣
+ *
+ * @param input_file ·
+ * @param options ȡ
+ * @return bool Ƿ rawvideo/Y4M ȡ
+ */
+bool is_pipe_input(const string& input_file, const ExtractOptions& options) {
+    if (input_file == "-" || input_file.rfind("\\\\.\\pipe\\", 0) == 0) return true;
+    string ext = extension_of(input_file);
+    if (ext == ".y4m") return true;
+    if (!options.raw_format.empty() && (ext == ".yuv" || ext == ".raw")) return true;
+    error_code ec;
+    return fs::is_fifo(input_file, ec);
+}
+
+// ʹõ rawvideo ʽ.y4m ļԴļͷ --raw_format
+string raw_format_of(const string& input_file, const ExtractOptions& options) {
+    return extension_of(input_file) == ".y4m" ? string() : options.raw_format;
+}
+
+/**
+ * @brief ӱ׼ܵȡ rawvideo/Y4M ֡ȡ
+ *
+ * ֻܵ˳ȡȡϣͬһ߳нУ֡ãֻҪ֡תΪBGR
+ * зֶΡҳϸؼ֡ͰʱãӦ֡ȻЧ
+ * 
+ * @param input_file "-" ʾ׼룬Ϊܵ.y4m ļ .yuv/.raw ļ
+ * @param output_folder ֡ļ·
+ * @param options ȡ
+ * @param slides ƵõĹϣΪ
+ * @return int ͼƬ޷ʱ -1
+ */
+int extract_frames_from_pipe(const string& input_file, const string& output_folder, const ExtractOptions& options,
+                             SlideIndex* slides) {
+    RawFrameReader reader;
+    string error;
+    if (!reader.open(input_file, raw_format_of(input_file, options), error)) {
+        cerr << error << endl;
+        return -1;
+    }
+    if (options.verbose && (options.segments > 1 || options.refine || options.build_index || options.time_based)) {
+        cout << "ܵ벻ֲ֧зֶΡҳϸؼ֡ͰʱѺ" << endl;
+    }
+
+    double fps = reader.fps();
+    int start_frame = (options.start <= 0) ? 0 : int(lround(options.start * 60 * fps));
+    int end_frame = (options.end <= 0) ? numeric_limits<int>::max() : int(lround(options.end * 60 * fps));
+    // 볤δ֪;ȱ
+    ProgressReporter progress_reporter(0, fps, options.progress_interval, start_frame, end_frame, options.verbose);
+
+    FrameHasher hasher;
+    if (!make_frame_hasher(options, reader.frame_size(), hasher)) return -1;
+    RawFrameSampler sampler(reader, start_frame, end_frame, options.frame_skip);
+    enable_adaptive_skip(sampler, options, hasher);
+    FrameKeeper keeper(output_folder, options.threshold, hasher, options.sad_floor, input_file, slides);
+    SampledFrame sample;
+    while (sampler.next(sample)) {
+        keeper.offer(sample);
+    }
+    if (options.verbose && options.sad_floor > 0) cout << "Ԥɸ " << keeper.unchanged_count() << " δ仯Ĳ֡" << endl;
+    if (options.verbose && slides) cout << "ϣ " << keeper.referenced_count() << " ţֻ references.csv" << endl;
+    progress_reporter.report_result(keeper.count());
+    return keeper.count();
 }
 
 // ȡ֡
 /**
  * @brief ƵļȡָΧ֡浽ָļС
+ *
+ * ڵ߳нУннǰ̼߳ϣȽ뱣档
  * 
  * @param input_file Ƶļ·
  * @param output_folder ֡ļ·
- * @param start ʼʱ䣨min
- * @param end ʱ䣨min
- * @param frame_skip ֡
- * @param progress_interval ʾʱ䣨min
- * @param threshold ƶȱȽֵ
+ * @param options ȡ
+ * @param slides ƵõĹϣΪ
+ * @return int ͼƬ޷Ƶʱ -1
  */
-void extract_frames(const string& input_file, const string& output_folder, int start, int end, int frame_skip, int progress_interval, int threshold) {
+int extract_frames(const string& input_file, const string& output_folder, const ExtractOptions& options,
+                   SlideIndex* slides = nullptr) {
+    if (is_pipe_input(input_file, options)) {
+        return extract_frames_from_pipe(input_file, output_folder, options, slides);
+    }
+
     // ƵļҼ֡Ȳ
     VideoCapture cap(input_file);
 
     if (!cap.isOpened()) {
-        cerr << "޷Ƶļ" << endl;
-        return;
+        cerr << "޷Ƶļ" << input_file << endl;
+        return -1;
+    }
+    FrameHasher hasher;
+    if (!make_frame_hasher(options, Size(int(cap.get(CAP_PROP_FRAME_WIDTH)), int(cap.get(CAP_PROP_FRAME_HEIGHT))), hasher)) {
+        return -1;
     }
 
-    int fps = cap.get(CAP_PROP_FPS); // ֡
-    int total_frames = cap.get(CAP_PROP_FRAME_COUNT); // ֡
-    double total_duration = total_frames / double(fps); // ʱs
+    // ؼ֡лʱֱӶȡ̽
+    KeyframeIndex keyframe_index;
+    bool has_index = load_or_probe_keyframe_index(input_file, cap, options.build_index, keyframe_index, options.verbose);
+    const KeyframeIndex* keyframes = (has_index && keyframe_index.usable()) ? &keyframe_index : nullptr;
 
-    int start_frame = (start <= 0) ? 0 : start * 60 * fps; // ʼ֡
-    int end_frame = (end <= 0) ? total_frames : min(end * 60 * fps, total_frames); // ֡
+    double fps = cap.get(CAP_PROP_FPS); // ֡ʣ֡29.97ȡʱƫƣ
+    int total_frames = has_index ? keyframe_index.frame_count : int(cap.get(CAP_PROP_FRAME_COUNT)); // ֡
+    double total_duration = total_frames / fps; // ʱs
+
+    int start_frame = (options.start <= 0) ? 0 : int(lround(options.start * 60 * fps)); // ʼ֡
+    int end_frame = (options.end <= 0) ? total_frames : min(int(lround(options.end * 60 * fps)), total_frames); // ֡
 
     // ãҪ
-    ProgressReporter progress_reporter(total_duration, fps, progress_interval, start_frame, end_frame);
-    vector<size_t> hash_list; // 洢ϣֵ
-    // set<size_t> hash_set; // 洢ϣֵ
-    int frame_count = 0; // ѾȡͼЧģ
-    int frame_index = start_frame;
-
-    Mat frame;
-    while (cap.isOpened()) {
-        cap.set(CAP_PROP_POS_FRAMES, frame_index);
-        if (!cap.read(frame)) break;
-
-        size_t img_hash = calculate_pHash(frame);
-        // TODO: õļ㷨
-        bool similar = false;
-
-        // // ϣֵǷ
-        // auto it = hash_set.lower_bound(img_hash);
-        // if (it != hash_set.end() && abs((int)(*it ^ img_hash)) < threshold) {
-        //     similar = true; // ҵƹϣֵ
-        // } else {
-        //     hash_set.insert(img_hash); // µĹϣֵ
-        // }
-
-
-        // hash_listеĹϣֵǷ
-        for (const auto& hash_value : hash_list) {
-            int hamming_distance = __builtin_popcount(hash_value ^ img_hash);
-            if (hamming_distance < threshold) {
-                similar = true;
-                break;
+    ProgressReporter progress_reporter(total_duration, fps, options.progress_interval, start_frame, end_frame, options.verbose);
+
+    // ˳ģʽֻڿʼʱλһ
+    double gop_length = 0;
+    if (keyframes) {
+        gop_length = keyframes->gop_length();
+        if (options.verbose) cout << "ؼ֡" << keyframes->keyframes.size() << " ؼ֡ƽGOP " << int(gop_length) << " ֡" << endl;
+    } else if (options.sequential) {
+        gop_length = estimate_gop_length(cap, start_frame, end_frame);
+        if (options.verbose) cout << "GOPȣ" << int(gop_length) << " ֡" << endl;
+    }
+
+    if (options.segments > 1) {
+        cap.release();
+        return extract_frames_parallel(input_file, output_folder, options, hasher, start_frame, end_frame, gop_length, keyframes, slides,
+                                       progress_reporter);
+    }
+    FrameSampler sampler(cap, start_frame, end_frame, options.frame_skip, options.sequential, gop_length);
+    sampler.set_keyframe_index(keyframes);
+    if (options.time_based) sampler.set_time_schedule(options.start * 60000.0, options.end * 60000.0, 1000 / fps);
+    if (options.luma_only && !sampler.request_raw_yuv() && options.verbose) {
+        cout << "ֱ֧YUVʹBGRϣ" << endl;
+    }
+    enable_adaptive_skip(sampler, options, hasher);
+    auto refiner = make_refiner(cap, options, fps, hasher);
+
+    // ̣߳ǰ֡Լϸõ֡
+    BoundedQueue<SampledFrame> queue(options.queue_depth);
+    exception_ptr decode_error;
+    thread decoder([&] {
+        try {
+            SampledFrame sample;
+            vector<SampledFrame> refined;
+            bool open = true;
+            while (open && sampler.next(sample)) {
+                refined.clear();
+                if (refiner) {
+                    refiner->refine(std::move(sample), refined);
+                } else {
+                    refined.push_back(std::move(sample));
+                }
+                for (auto& item : refined) {
+                    if (!(open = queue.push(std::move(item)))) break;
+                }
+                sample = SampledFrame();
             }
+        } catch (...) {
+            decode_error = current_exception();
         }
-
-        if (!similar) {
-            double elapsed_time = cap.get(CAP_PROP_POS_FRAMES) / double(fps); // ǰѴƵʱ䣨s
-            string frame_path = output_folder + "/frame_" + to_string(int(elapsed_time / 60)) + "min_" + to_string(frame_count) + ".jpg";
-            imwrite(frame_path, frame);
-            hash_list.push_back(img_hash);
-            progress_reporter.report_progress(elapsed_time, frame_count);
-            frame_count++;
+        queue.close();
+    });
+    // Ժַʽ뿪ʱ׳쳣ȹرնʹ߳˳ȴ
+    // Կɽϵֹ̻̣߳еƵҲ޷
+    struct DecoderGuard {
+        BoundedQueue<SampledFrame>& queue;
+        thread& decoder;
+        ~DecoderGuard() {
+            queue.close();
+            if (decoder.joinable()) decoder.join();
         }
+    } decoder_guard{queue, decoder};
 
-        if (cap.get(CAP_PROP_POS_FRAMES) >= end_frame) break;
-        frame_index += frame_skip;
+    FrameKeeper keeper(output_folder, options.threshold, hasher, options.sad_floor, input_file, slides);
+    SampledFrame sample;
+    while (queue.pop(sample)) {
+        if (keeper.offer(sample)) {
+            progress_reporter.report_progress(sample.timestamp / 1000, keeper.count() - 1);
+        }
     }
 
+    decoder.join();
     cap.release();
-    progress_reporter.report_result(frame_count);
+    if (decode_error) rethrow_exception(decode_error);
+    if (options.verbose && options.sad_floor > 0) cout << "Ԥɸ " << keeper.unchanged_count() << " δ仯Ĳ֡" << endl;
+    if (options.verbose && slides) cout << "ϣ " << keeper.referenced_count() << " ţֻ references.csv" << endl;
+    progress_reporter.report_result(keeper.count());
+    return keeper.count();
 }
 
 // ȡǰʱ䲢ʽΪ "output_MMDD_HHmmss"
@@ -239,7 +902,376 @@ string get_input(const string& prompt, const string& default_prompt, const strin
     return input.empty() ? default_value : input; // Ϊգ򷵻Ĭֵ
 }
 
-int main() {
+// 
+struct BatchOptions {
+    vector<string> inputs;  // 룺ƵļƵĿ¼бļ.txtÿһ·
+    string output_root;     // Ŀ¼ÿƵƵļļ
+    int workers = 1;        // ͬʱƵ
+    ExtractOptions extract; // ȡƵͬ
+};
+
+/**
+ * @brief һȡкļͬһơ
+ * 
+ * @param options ȡ
+ * @param name 
+ * @param value ֵͲ0/1ʾ
+ * @param valid ȡֵǷЧЧʱֲ
+ * @return bool ǷЧ
+ */
+bool set_extract_option(ExtractOptions& options, const string& name, int value, bool& valid) {
+    valid = true;
+    if (name == "start") options.start = value;
+    else if (name == "end") options.end = value;
+    else if (name == "frame_skip") options.frame_skip = value;
+    else if (name == "max_skip") options.max_skip = value;
+    else if (name == "refine") options.refine = value != 0;
+    else if (name == "time_based") options.time_based = value != 0;
+    else if (name == "progress_interval") options.progress_interval = value;
+    else if (name == "threshold") options.threshold = value;
+    else if (name == "sequential") options.sequential = value != 0;
+    else if (name == "queue_depth") options.queue_depth = value;
+    else if (name == "segments") options.segments = value;
+    else if (name == "build_index") options.build_index = value != 0;
+    else if (name == "luma_only") options.luma_only = value != 0;
+    else if (name == "hash_bits") {
+        valid = value == 64 || value == 128 || value == 256;
+        if (valid) options.hash_bits = value;
+    }
+    else if (name == "tile_rows" || name == "tile_cols") {
+        valid = value >= 0 && value <= 4; // 44 ռ256λ
+        if (valid) (name == "tile_rows" ? options.tile_rows : options.tile_cols) = value;
+    }
+    else if (name == "sad_floor") {
+        valid = value >= 0;
+        if (valid) options.sad_floor = value;
+    }
+    else if (name == "colour") options.colour = value != 0;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief ַΪ
+ * 
+ * @param text ַ
+ * @param value ʧʱֲ
+ * @return bool Ƿɹжַ "4x"򳬳Χʱʧ
+ */
+bool parse_int(const string& text, int& value) {
+    try {
+        size_t pos = 0;
+        int parsed = stoi(text, &pos);
+        if (pos != text.size()) return false;
+        value = parsed;
+        return true;
+    } catch (const logic_error&) {
+        return false;
+    }
+}
+
+/**
+ * @brief һıȡȼٰıΪ
+ * 
+ * @param options ȡ
+ * @param name 
+ * @param text ֵı
+ * @param valid ȡֵǷЧܷΪЧʱֲ
+ * @return bool ǷЧ
+ */
+bool set_extract_option(ExtractOptions& options, const string& name, const string& text, bool& valid) {
+    int value = 0;
+    bool parsed = parse_int(text, value);
+    ExtractOptions updated = options;
+    if (!set_extract_option(updated, name, value, valid)) return false;
+    valid = valid && parsed;
+    if (valid) options = updated;
+    return true;
+}
+
+// ļıСַбʱΪգЧȡֵ
+string config_integer(const FileNode& node) {
+    return node.isInt() ? to_string((int)node) : string();
+}
+
+/**
+ * @brief üϣĻкļá
+ * 
+ * @param options ȡ
+ * @param name roiexclude  mask
+ * @param value ֵroi Ϊ "x,y,,"exclude ΪԷֺŷָĶΣmask Ϊͼ·
+ * @param valid ȡֵǷЧ
+ * @return bool ǷΪ
+ */
+bool set_region_option(ExtractOptions& options, const string& name, const string& value, bool& valid) {
+    valid = true;
+    if (name == "roi") {
+        vector<Rect> rects;
+        valid = parse_rects(value, rects) && rects.size() <= 1;
+        if (valid) options.roi = rects.empty() ? Rect() : rects[0];
+    } else if (name == "exclude") {
+        valid = parse_rects(value, options.exclusions);
+    } else if (name == "mask") {
+        options.mask_file = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ȡļOpenCV FileStorage ʽYAML/JSON/XML ɣ
+ *
+ * ɰ inputsַַбoutputworkers Լͬȡ
+ * 
+ * @param config_file ļ·
+ * @param batch ȡļûеֲ
+ * @return bool Ƿȡɹ
+ */
+bool load_batch_config(const string& config_file, BatchOptions& batch) {
+    try {
+        FileStorage fs(config_file, FileStorage::READ);
+        if (!fs.isOpened()) return false;
+        FileNode root = fs.root();
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            FileNode node = *it;
+            string name = node.name();
+            if (name == "inputs") {
+                if (node.isSeq()) {
+                    for (auto item = node.begin(); item != node.end(); ++item) batch.inputs.push_back((string)*item);
+                } else {
+                    batch.inputs.push_back((string)node);
+                }
+            } else if (name == "output") {
+                batch.output_root = (string)node;
+            } else if (name == "workers") {
+                if (!parse_int(config_integer(node), batch.workers)) cerr << " workers ȡֵЧӦΪ" << endl;
+            } else if (name == "raw_format") {
+                batch.extract.raw_format = (string)node;
+            } else if (name == "index") {
+                batch.extract.index_file = (string)node;
+            } else if (name == "hash") {
+                if (!parse_hash_kind((string)node, batch.extract.hash_kind)) cerr << "δ֪Ĺϣ㷨" << (string)node << endl;
+            } else if (bool valid; set_region_option(batch.extract, name, (string)node, valid)) {
+                if (!valid) cerr << " " << name << " ȡֵЧ" << (string)node << endl;
+            } else if (bool valid; set_extract_option(batch.extract, name, config_integer(node), valid)) {
+                if (!valid && node.isInt()) cerr << " " << name << " ȡֵЧ" << (int)node << endl;
+                if (!valid && !node.isInt()) cerr << " " << name << " ȡֵЧӦΪ" << endl;
+            } else {
+                cerr << "ļеδ֪" << name << endl;
+            }
+        }
+    } catch (const cv::Exception& e) {
+        cerr << "޷ļ" << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
+// ÷
+void print_usage(const char* program) {
+    cout << "÷" << program << " [ѡ] ...\n"
+         << "ƵļƵĿ¼бļ.txtÿһ·\n"
+         << "ѡ\n"
+         << "  --config <ļ>      ȡļеĲ\n"
+         << "  --output <Ŀ¼>      Ŀ¼ÿƵļļУĬ output_MMDD_HHmmss\n"
+         << "  --workers <N>        ͬʱƵĬ 1\n"
+         << "  --<> <ֵ>      ȡstart end frame_skip max_skip refine time_based progress_interval\n"
+         << "                       threshold sequential queue_depth segments build_index luma_only hash_bits\n"
+         << "                       tile_rows tile_cols sad_floor colourͲ0/1\n"
+         << "  --raw_format <ʽ>  Ϊ - ׼룩ܵ .yuv/.raw ļʱrawvideoȡ\n"
+         << "                       ʽΪ x:ظʽ[:֡]ظʽΪ gray bgr24 yuv420p nv12 nv21\n"
+         << "                       ָʱY4MȡƵļӰ\n"
+         << "  --hash <㷨>        ֪ϣ㷨ahash dhash phash blockmean haarĬ phash\n"
+         << "  --roi <x,y,,>    ֻûеһϣֻȡõƬڵ\n"
+         << "  --exclude <>     ϣʱų򣬶÷ֺŷָ \"1600,0,320,180;0,1000,200,80\"\n"
+         << "  --mask <ͼ>        ͼ񣬺ɫֲϣŵߴʹã\n"
+         << "  --index <ļ>       Ƶ֮УõĹϣеĻ治\n"
+         << "                       ֻļе references.csvĻ׷ӵУʱ\n";
+}
+
+/**
+ * @brief в
+ * 
+ * @param argc 
+ * @param argv 
+ * @param batch 
+ * @return bool ǷЧ
+ */
+bool parse_arguments(int argc, char* argv[], BatchOptions& batch) {
+    // ȶȡļʹвԸеֵ
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--config" && !load_batch_config(argv[i + 1], batch)) {
+            cerr << "޷ȡļ" << argv[i + 1] << endl;
+            return false;
+        }
+    }
+
+    vector<string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help") return false;
+        if (arg.rfind("--", 0) != 0) {
+            inputs.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "ȱȡֵ" << arg << endl;
+            return false;
+        }
+        string name = arg.substr(2), value = argv[++i];
+        bool valid = true;
+        if (name == "config") continue;
+        if (name == "output") batch.output_root = value;
+        else if (name == "workers") valid = parse_int(value, batch.workers);
+        else if (name == "raw_format") batch.extract.raw_format = value;
+        else if (name == "index") batch.extract.index_file = value;
+        else if (name == "hash") {
+            if (!parse_hash_kind(value, batch.extract.hash_kind)) {
+                cerr << "δ֪Ĺϣ㷨" << value << endl;
+                return false;
+            }
+        }
+        else if (!set_region_option(batch.extract, name, value, valid)
+                 && !set_extract_option(batch.extract, name, value, valid)) {
+            cerr << "δ֪" << arg << endl;
+            return false;
+        }
+        if (!valid) {
+            cerr << " " << arg << " ȡֵЧ" << value << endl;
+            return false;
+        }
+    }
+    if (!inputs.empty()) batch.inputs = inputs; // е滻ļе
+    if (batch.output_root.empty()) batch.output_root = get_default_output_folder_name();
+    batch.workers = max(1, batch.workers);
+    return !batch.inputs.empty();
+}
+
+/**
+ * @brief չ룺Ŀ¼ȡеƵļļ򣩣бļжȡΪƵļ
+ * 
+ * @param inputs лļе
+ * @return vector<string> Ƶļ·
+ */
+vector<string> collect_videos(const vector<string>& inputs) {
+    static const set<string> video_extensions = {".mp4", ".mkv", ".avi", ".mov", ".flv", ".wmv", ".webm", ".ts", ".m4v"};
+    vector<string> videos;
+    for (const auto& input : inputs) {
+        error_code ec;
+        if (fs::is_directory(input, ec)) {
+            vector<string> found;
+            for (const auto& entry : fs::directory_iterator(input, ec)) {
+                if (entry.is_regular_file(ec) && video_extensions.count(extension_of(entry.path()))) {
+                    found.push_back(entry.path().string());
+                }
+            }
+            sort(found.begin(), found.end());
+            videos.insert(videos.end(), found.begin(), found.end());
+        } else if (extension_of(input) == ".txt") {
+            ifstream list(input);
+            if (!list) cerr << "޷ȡбļ" << input << endl;
+            string line;
+            while (getline(list, line)) {
+                // ȥβհ׺Windowsзк#ͷע
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == string::npos || line[first] == '#') continue;
+                size_t last = line.find_last_not_of(" \t\r");
+                videos.push_back(line.substr(first, last - first + 1));
+            }
+        } else {
+            videos.push_back(input);
+        }
+    }
+    return videos;
+}
+
+/**
+ * @brief ɹ߳ȡƵÿƵļС
+ *
+ * ĽرգֻڿʼͽʱһУƵʧܲӰƵ
+ * ָ˹ϣʱͬһͬһŻõƬγֻһΡ
+ * 
+ * @param batch 
+ * @return int ̷ֵƵʧʱΪ1
+ */
+int run_batch(const BatchOptions& batch) {
+    vector<string> videos = collect_videos(batch.inputs);
+    if (videos.empty()) {
+        cerr << "ûҵƵ" << endl;
+        return 1;
+    }
+
+    // ļƵļʱ׷
+    vector<string> folders;
+    set<string> used;
+    for (const auto& video : videos) {
+        string stem = (video == "-") ? "stdin" : fs::path(video).stem().string();
+        string name = stem;
+        for (int n = 2; !used.insert(name).second; ++n) name = stem + "_" + to_string(n);
+        folders.push_back((fs::path(batch.output_root) / name).string());
+    }
+
+    ExtractOptions options = batch.extract;
+    options.verbose = false;
+    SlideIndex slides;
+    if (!options.index_file.empty() && !open_slide_index(options, slides)) return 1;
+    SlideIndex* shared = options.index_file.empty() ? nullptr : &slides;
+    atomic<size_t> next_job(0);
+    atomic<int> failed(0);
+    mutex console;
+    auto start_time = chrono::high_resolution_clock::now();
+
+    auto worker = [&] {
+        for (size_t i = next_job++; i < videos.size(); i = next_job++) {
+            string tag = "[" + to_string(i + 1) + "/" + to_string(videos.size()) + "] ";
+            {
+                lock_guard<mutex> lock(console);
+                cout << tag << "ʼ" << videos[i] << endl;
+            }
+            auto job_start = chrono::high_resolution_clock::now();
+            int frame_count = -1;
+            error_code ec;
+            fs::create_directories(folders[i], ec);
+            try {
+                if (!ec) frame_count = extract_frames(videos[i], folders[i], options, shared);
+            } catch (const exception& e) {
+                lock_guard<mutex> lock(console);
+                cerr << tag << "" << e.what() << endl;
+            }
+            chrono::duration<double> job_time = chrono::high_resolution_clock::now() - job_start;
+
+            lock_guard<mutex> lock(console);
+            if (frame_count < 0) {
+                failed++;
+                cerr << tag << "ʧܣ" << videos[i] << endl;
+            } else {
+                cout << tag << "ɣ" << videos[i] << " -> " << folders[i] << "ͼƬ" << frame_count
+                     << "ʱ" << time_format(job_time.count()) << endl;
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (int i = 0; i < min<int>(batch.workers, int(videos.size())); ++i) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+
+    chrono::duration<double> total_time = chrono::high_resolution_clock::now() - start_time;
+    cout << " " << videos.size() << " Ƶʧ " << failed << " ʱ" << time_format(total_time.count()) << endl;
+    return failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    // ʱģʽٽ
+    if (argc > 1) {
+        BatchOptions batch;
+        if (!parse_arguments(argc, argv, batch)) {
+            print_usage(argv[0]);
+            return 2;
+        }
+        return run_batch(batch);
+    }
+
     string input_file = get_input("Ƶļ·", "1.mp4", "1.mp4");
     string output_folder = get_input("ļ·", "output_MMDD_HHmmss", get_default_output_folder_name());
     // ļвڣ򴴽
@@ -247,16 +1279,51 @@ int main() {
         fs::create_directories(output_folder);
     }
 
-    int start = stoi(get_input("()", "ͷ", "0"));
-    int end = stoi(get_input("յ()", "β", "-1"));
-    int frame_skip = stoi(get_input("ֵ֡", "30", "30"));
-    int progress_interval = stoi(get_input("ʾʱ()", "5", "5"));
-    int threshold = stoi(get_input("ƶȱȽֵ", "4", "4"));
+    ExtractOptions options;
+    options.start = stoi(get_input("()", "ͷ", "0"));
+    options.end = stoi(get_input("յ()", "β", "-1"));
+    options.frame_skip = stoi(get_input("ֵ֡", "30", "30"));
+    options.max_skip = stoi(get_input("Ӧ֡(֡)", "", "0"));
+    options.refine = get_input("Ƿֶλҳλ(y/n)", "n", "n") == "y";
+    options.time_based = get_input("Ƿʱ(ڿɱ֡)(y/n)", "n", "n") == "y";
+    options.progress_interval = stoi(get_input("ʾʱ()", "5", "5"));
+    options.threshold = stoi(get_input("ƶȱȽֵ", "4", "4"));
+    options.sad_floor = stoi(get_input("Ԥɸ(0Ϊ)", "", "0"));
+    if (!parse_hash_kind(get_input("ѡϣ㷨(ahash/dhash/phash/blockmean/haar)", "phash", "phash"), options.hash_kind)) {
+        cout << "δ֪Ĺϣ㷨ʹphash" << endl;
+    }
+    bool valid;
+    set_extract_option(options, "hash_bits", stoi(get_input("ϣλ(64/128/256)", "64", "64")), valid);
+    if (!valid) cout << "ϣλֻΪ64128256ʹ64" << endl;
+    options.colour = get_input("ǷȽɫ(ֻıɫĻҲΪµһҳ)(y/n)", "n", "n") == "y";
+    int tile_rows = 0, tile_cols = 0;
+    char x = 0;
+    istringstream tiles(get_input("ָϣx(4x4ֵȽ)", "", "0x0"));
+    valid = (tiles >> tile_rows >> x >> tile_cols) && x == 'x';
+    if (valid) set_extract_option(options, "tile_rows", tile_rows, valid);
+    if (valid) set_extract_option(options, "tile_cols", tile_cols, valid);
+    if (!valid) {
+        cout << "ָʽЧ򳬹4x4" << endl;
+        options.tile_rows = options.tile_cols = 0;
+    }
+    set_region_option(options, "roi", get_input("ϣĻ(x,y,,)", "", ""), valid);
+    if (!valid) cout << "ʽЧʹ" << endl;
+    set_region_option(options, "exclude", get_input("ų(x,y,,;...)", "", ""), valid);
+    if (!valid) cout << "ųʽЧų" << endl;
+    options.sequential = get_input("Ƿʹ˳(y/n)", "y", "y") != "n";
+    options.queue_depth = stoi(get_input("(֡)", "8", "8"));
+    options.segments = stoi(get_input("벢зֶ", "1", "1"));
+    options.build_index = get_input("ûйؼ֡ʱǷȽ(y/n)", "n", "n") == "y";
+    options.luma_only = get_input("Ƿֻȼϣ(y/n)", "y", "y") != "n";
+    options.index_file = get_input("빲õĹϣļ(ƵеĻ治)", "ʹ", "");
 
     // TODO: Ӵʾ
 
     // Ĵ
-    extract_frames(input_file, output_folder, start, end, frame_skip, progress_interval, threshold);
+    SlideIndex slides;
+    if (options.index_file.empty() || open_slide_index(options, slides)) {
+        extract_frames(input_file, output_folder, options, options.index_file.empty() ? nullptr : &slides);
+    }
     system("PAUSE");
 
     return 0;
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "hash_list.hpp"
+#include "hash_value.hpp"
+
+/**
+ * @brief ϣ֯BKֲ֧Ͱ뾶ѯ
+ *
+ * ÿӽڵ¼븸ڵľ dѯ븸ڵľΪ q ʱǲʽ
+ * 뾶 r ڵĽֻ |d - q| <= r У
+ * ͷָ루ֵǲʽ
+ *
+ * ڵӽڵ飨arenaУ±껥ӣûС
+ * ѯʱҪӽڵľ룬ӽڵзֿ飺ÿ8ӽڵľ±꣬
+ * һڵȫӽڵֻȡУҪӽڵ㱾
+ */
+class BKTree {
+public:
+    explicit BKTree(HashDistance distance = HashDistance::hamming()) : distance(distance), hashes(distance.words) {}
+
+/**
+ * @brief һϣֵͬĹϣֵҲ룬Աţ
+ *
+ * @param hash ϣֵ
+ * @return int 
+ */
+    int insert(const FrameHash& hash) {
+        int id = int(hashes.size());
+        hashes.push_back(hash);
+        first_block.push_back(-1);
+        if (id == 0) return id;
+
+        int node = 0;
+        for (;;) {
+            int d = distance(hashes.data(node), hash.words.data());
+            int child = find_child(node, d);
+            if (child < 0) {
+                add_child(node, d, id);
+                return id;
+            }
+            node = child;
+        }
+    }
+
+/**
+ * @brief 뾶ѯ벻 radius йϣֵ
+ *
+ * @param hash ѯĹϣֵ
+ * @param radius 뾶
+ * @param result ţ˳򲻶׷ӵĩβ
+ */
+    void query(const FrameHash& hash, int radius, std::vector<int>& result) const {
+        search(hash, radius, [&](int id) {
+            result.push_back(id);
+            return false;
+        });
+    }
+
+/**
+ * @brief һ hash ľС threshold Ĺϣֵҵء
+ *
+ * @param hash ѯĹϣֵ
+ * @param threshold ޣ
+ * @return int ţûʱ -1
+ */
+    int find_within(const FrameHash& hash, int threshold) const {
+        int found = -1;
+        search(hash, threshold - 1, [&](int id) {
+            found = id;
+            return true;
+        });
+        return found;
+    }
+
+    size_t size() const { return hashes.size(); }
+    bool empty() const { return hashes.empty(); }
+    FrameHash operator[](size_t id) const { return hashes[id]; }
+
+    // Ԥڵռ
+    void reserve(size_t count) {
+        hashes.reserve(count);
+        first_block.reserve(count);
+        blocks.reserve(count / 4);
+    }
+
+private:
+    static constexpr int block_size = 8; // ÿӽڵ
+
+    // ӽڵһ飬ռһ
+    struct alignas(64) ChildBlock {
+        uint16_t edges[block_size]; // ӽڵ븸ڵľ
+        int nodes[block_size];      // ӽڵ
+        int count;                  // ʹõĸ
+        int next;                   // ͬһڵһ飬ûʱΪ -1
+    };
+
+    //  node ľΪ d ӽڵ㣬ûʱ -1
+    int find_child(int node, int d) const {
+        for (int b = first_block[node]; b >= 0; b = blocks[b].next) {
+            const ChildBlock& block = blocks[b];
+            for (int k = 0; k < block.count; ++k) {
+                if (block.edges[k] == d) return block.nodes[k];
+            }
+        }
+        return -1;
+    }
+
+    //  node ӽڵмΪ d ӽڵ㣬׿ʱǰһ
+    void add_child(int node, int d, int child) {
+        int b = first_block[node];
+        if (b < 0 || blocks[b].count == block_size) {
+            ChildBlock block;
+            block.count = 0;
+            block.next = b;
+            b = first_block[node] = int(blocks.size());
+            blocks.push_back(block);
+        }
+        ChildBlock& block = blocks[b];
+        block.edges[block.count] = uint16_t(d);
+        block.nodes[block.count] = child;
+        block.count++;
+    }
+
+    // ȱ뾶ڵĽڵ㣬visit  true ʱֹͣ
+    template <typename Visit>
+    void search(const FrameHash& hash, int radius, Visit visit) const {
+        if (hashes.empty() || radius < 0) return;
+        thread_local std::vector<int> pending; // ʵĽڵ㣬ÿβѯ
+        pending.clear();
+        pending.push_back(0);
+        while (!pending.empty()) {
+            int node = pending.back();
+            pending.pop_back();
+            int d = distance(hashes.data(node), hash.words.data());
+            if (d <= radius && visit(node)) return;
+            for (int b = first_block[node]; b >= 0; b = blocks[b].next) {
+                const ChildBlock& block = blocks[b];
+                for (int k = 0; k < block.count; ++k) {
+                    if (std::abs(block.edges[k] - d) <= radius) pending.push_back(block.nodes[k]);
+                }
+            }
+        }
+    }
+
+    HashDistance distance;          // ϣ
+    HashList hashes;                // ڵĹϣֵ±꼴ţڵΪ0
+    std::vector<int> first_block;   // ڵӽڵĵһ飬ûӽڵʱΪ -1
+    std::vector<ChildBlock> blocks; // ӽڵ
+};
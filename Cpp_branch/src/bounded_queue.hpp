@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief нУڽ߳봦֮߳䴫֡
+ *
+ * ʱ push пʱ pop close ֮ push ʧܣpop ȡʣԪغʧܡ
+ *
+ * @tparam T Ԫ
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+    /**
+     * @brief һԪأʱȴ
+     *
+     * @param item Ԫ
+     * @return bool ѹرʱ false
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief ȡһԪأпʱȴ
+     *
+     * @param item ȡԪ
+     * @return bool ѹرΪʱ false
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    // رնУеȴ߳
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    const size_t capacity;         // Ԫ
+    std::deque<T> items;           // 
+    bool closed = false;           // Ƿѹر
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "kernels.hpp"
+#include "pixel_layout.hpp"
+
+/**
+ * @brief ɿԤɸõ 169 ͼÿΪԴͼӦ򣨸жȡֽڵƽֵ
+ *
+ * ֻжϻǷ仯ҶȼȨBGRȡͨƽ4:2:0ֻȡYƽ棬YUVͬɫһƽ
+ *
+ * @param raw 
+ * @param layout Ų
+ * @param roi ֻʹûеһΪʱʹ
+ * @param tiny  169 ƽֵȣ
+ */
+inline void tiny_thumbnail(const cv::Mat& raw, PixelLayout layout, const cv::Rect& roi, float* tiny) {
+    int width = raw.cols, height = raw.rows, channels = raw.channels();
+    switch (layout) {
+    case PixelLayout::I420:
+    case PixelLayout::YV12:
+    case PixelLayout::NV12:
+    case PixelLayout::NV21:
+        height = raw.rows * 2 / 3;
+        break;
+    default:
+        break;
+    }
+    cv::Rect region = roi & cv::Rect(0, 0, width, height);
+    if (region.empty()) region = cv::Rect(0, 0, width, height);
+    const uint8_t* data = raw.ptr<uint8_t>(region.y) + size_t(region.x) * channels;
+    cpu_kernels().tiny_thumbnail(data, raw.step, region.width, region.height, channels, tiny);
+}
+
+/**
+ * @brief ԤɸһͨԤɸĲ֡Ƚ 169 ͼиӵĲʱжΪδ仯
+ * ϣѱ֡ıȽϡ
+ *
+ * ֻ֡жΪ仯ʱ£˻Ľ䲻Ϊ֡ۻ©
+ * ֵܲжϣһʵı仯ᱻ಻ĸӳ嵭
+ * ų򣨻лʱӵȣصĸӲȽϣЩı仯ʹÿ֡жΪ仯
+ *
+ * ֻʽжϣ޲֤ϣֵȽϵҲһͨԤɸĲ֡
+ * һ֡Ĭϲá
+ */
+class ChangeFilter {
+public:
+/**
+ * @brief 캯
+ *
+ * @param noise_floor ޣƽֵ֮Ҷȼ0 ʾ
+ * @param roi ȽϵΪʱʹ
+ * @param excluded Ƚϵĸӣ169ȣΪʱȽи
+ */
+    explicit ChangeFilter(int noise_floor = 0, const cv::Rect& roi = cv::Rect(), const std::vector<uint8_t>& excluded = {})
+        : noise_floor(noise_floor), roi(roi), excluded(excluded) {}
+
+/**
+ * @brief жϲ֡֡Ƿδ仯仯ʱΪµĲ֡
+ *
+ * @param raw 
+ * @param layout Ų
+ * @return bool Ƿδ仯δûûв֡ʱ false
+ */
+    bool unchanged(const cv::Mat& raw, PixelLayout layout) {
+        if (noise_floor <= 0) return false;
+        float tiny[tiny_rows * tiny_cols];
+        tiny_thumbnail(raw, layout, roi, tiny);
+        if (has_reference) {
+            float worst = 0;
+            for (int i = 0; i < tiny_rows * tiny_cols; ++i) {
+                if (excluded.empty() || !excluded[i]) worst = std::max(worst, std::abs(tiny[i] - reference[i]));
+            }
+            if (worst < noise_floor) {
+                skipped++;
+                return true;
+            }
+        }
+        std::copy(tiny, tiny + tiny_rows * tiny_cols, reference);
+        has_reference = true;
+        return false;
+    }
+
+    // жΪδ仯֡
+    int skipped_count() const { return skipped; }
+
+private:
+    int noise_floor;                          // ޣ0 ʾ
+    cv::Rect roi;                             // Ƚϵ
+    std::vector<uint8_t> excluded;            // ȽϵĸӣΪʱȽи
+    float reference[tiny_rows * tiny_cols];   // ֡ͼ
+    bool has_reference = false;               // Ƿв֡
+    int skipped = 0;                          // жΪδ仯֡
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "hash_value.hpp"
+#include "kernels.hpp"
+
+// ɫǩ44飬ÿ 88 ͼԪ
+constexpr int colour_grid = 4;
+
+// ÿռõλɫ仯ʱЩλͬʱתһı仯ﵽĬֵ4
+constexpr int colour_weight = 64 / (colour_grid * colour_grid);
+
+// жΪɫĵԪɫȱҳɫ߳ޣ0255ѹԶڴֵһֵĵԪɴ50
+constexpr float colour_floor = 24;
+
+// ɫǩĸʽϣıǩļ㷽ʱʹ޷µǩ
+constexpr uint32_t colour_format = 2;
+
+// ɫǩڹϣ֮ĵһУ64λϣΪ1֣128λΪ2֣
+// 256λϣͷָϣռ FrameHashܸ
+constexpr int colour_word(int hash_bits) { return hash_bits / 64; }
+
+/**
+ * @brief  3232 ɫͼ64λɫǩһԪɫȱҳɫ߳ʱÿ colour_weight λΪ1
+ * ȣλǰ
+ *
+ * ȹϣֻıɫı仯ݽ߰ĳһб죩ǩڹϣֵ֮δʹõУ
+ * ˵ȹϣľ colour_weightɫ޷仯ĿȥرȽϺ͸Ҫ
+ * ҳɫȡԪɫȵλɫģĵɫʹÿһ鶼Ϊɫɫͼֻбͳ̶ȣ
+ * ɫ࣬ͳ̶ɫ֮滻ָΪ֣޷֡
+ *
+ * @param chroma 3232 ɫͼ make_thumbnail
+ * @return uint64_t ɫǩ
+ */
+inline uint64_t colour_signature(const float* chroma) {
+    constexpr int cells = thumbnail_size * thumbnail_size;
+    constexpr int block = thumbnail_size / colour_grid;
+    constexpr uint64_t block_bits = (uint64_t(1) << colour_weight) - 1;
+    float sorted[cells];
+    std::copy(chroma, chroma + cells, sorted);
+    std::nth_element(sorted, sorted + cells / 2, sorted + cells);
+    float coloured = sorted[cells / 2] + colour_floor; // ɫԪɫ
+
+    uint64_t signature = 0;
+    for (int by = 0; by < colour_grid; ++by) {
+        for (int bx = 0; bx < colour_grid; ++bx) {
+            float peak = 0;
+            for (int r = by * block; r < (by + 1) * block; ++r) {
+                const float* row = chroma + r * thumbnail_size + bx * block;
+                peak = std::max(peak, *std::max_element(row, row + block));
+            }
+            int shift = 64 - (by * colour_grid + bx + 1) * colour_weight;
+            if (peak >= coloured) signature |= block_bits << shift;
+        }
+    }
+    return signature;
+}
+
+// ɫǩд hash_bits λĹϣֵ֮
+inline void add_colour_signature(FrameHash& hash, int hash_bits, const float* chroma) {
+    hash.words[colour_word(hash_bits)] = colour_signature(chroma);
+}
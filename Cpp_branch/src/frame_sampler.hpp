@@ -0,0 +1,322 @@
+#pragma once
+
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+
+#include "hash_value.hpp"
+#include "keyframe_index.hpp"
+#include "pixel_layout.hpp"
+
+// һ֡
+struct SampledFrame {
+    cv::Mat frame;        // ͼ
+    PixelLayout layout = PixelLayout::BGR; // ͼŲ
+    int frame_index = 0;  // ֡
+    double position = 0;  // ȡ CAP_PROP_POS_FRAMES
+    double timestamp = 0; // ʾʱms
+    FrameHash hash;       // ʱѼĹϣֵ
+    bool hashed = false;  // hash ǷЧ
+};
+
+/**
+ * @brief ƵGOPȣ֡
+ *
+ * OpenCVṩؼ֡ϢͨλĴ۷ƣFFmpeg˶λʱصǰһؼ֡֡룬
+ * λһεƽʱԼΪGOPĽʱ
+ *
+ * @param cap Ѵ򿪵Ƶ
+ * @param start_frame ʼ֡
+ * @param end_frame ֡
+ * @return double ƵGOPȣ֡
+ */
+inline double estimate_gop_length(cv::VideoCapture& cap, int start_frame, int end_frame) {
+    const int grab_samples = 16; // ڲ֡ʱ֡
+    const int seek_samples = 4;  // ڲλʱĴ
+    using clock = std::chrono::high_resolution_clock;
+
+    // ˳뵥֡ĺʱһ֡λ룩
+    cap.set(cv::CAP_PROP_POS_FRAMES, start_frame);
+    if (!cap.grab()) return 1;
+    auto t0 = clock::now();
+    int grabbed = 0;
+    while (grabbed < grab_samples && cap.grab()) grabbed++;
+    std::chrono::duration<double> grab_time = clock::now() - t0;
+    if (grabbed == 0) return 1;
+    double grab_cost = grab_time.count() / grabbed;
+
+    // λڸĺʱ
+    double seek_cost = 0;
+    for (int i = 0; i < seek_samples; ++i) {
+        int target = start_frame + int((i + 0.5) * (end_frame - start_frame) / seek_samples);
+        auto t1 = clock::now();
+        cap.set(cv::CAP_PROP_POS_FRAMES, target);
+        cap.grab();
+        std::chrono::duration<double> seek_time = clock::now() - t1;
+        seek_cost += seek_time.count() / seek_samples;
+    }
+
+    if (grab_cost <= 0) return 1;
+    return std::max(1.0, 2 * seek_cost / grab_cost);
+}
+
+/**
+ * @brief Ƶȡ grab() ֡δɫתYUVݡ
+ *
+ * ˽ҲBGRԵһ֡ʵ״ȷŲֻƽ棨ɫȣʱ޷ԭɫ
+ * ĻɺBGR˳ͷֶβе½빲ãͼƬͬת
+ */
+class FrameRetriever {
+public:
+    explicit FrameRetriever(cv::VideoCapture& cap) : cap(cap) {}
+
+/**
+ * @brief ֱδɫתYUVݡ
+ *
+ * @return bool ǷܣʱBGR
+ */
+    bool request_raw_yuv() {
+        raw_yuv = cap.set(cv::CAP_PROP_CONVERT_RGB, 0);
+        return raw_yuv;
+    }
+
+/**
+ * @brief ȡǰ֡һ֡ʱȷŲ
+ *
+ * @param frame ͼ
+ * @return bool Ƿɹ
+ */
+    bool retrieve(cv::Mat& frame) {
+        if (!cap.retrieve(frame)) return false;
+        if (layout_known) return true;
+        layout = raw_yuv ? detect_pixel_layout(frame, int(cap.get(cv::CAP_PROP_FRAME_HEIGHT)),
+                                               int(cap.get(cv::CAP_PROP_CODEC_PIXEL_FORMAT)))
+                         : PixelLayout::BGR;
+        if (layout == PixelLayout::Gray) {
+            // ͼƬɻҶȣĻɺBGR֡ȡ
+            raw_yuv = false;
+            cap.set(cv::CAP_PROP_CONVERT_RGB, 1);
+            layout = PixelLayout::BGR;
+            if (!cap.retrieve(frame)) return false;
+        }
+        layout_known = true;
+        return true;
+    }
+
+    // ȡ֡Ų
+    PixelLayout pixel_layout() const { return layout; }
+
+private:
+    cv::VideoCapture& cap;
+    bool raw_yuv = false;                  // ǷδתYUV
+    bool layout_known = false;             // ǷȷŲ
+    PixelLayout layout = PixelLayout::BGR; // Ų
+};
+
+/**
+ * @brief Ӧ֡
+ *
+ * ڲ֡Ĺϣ뱣ֵûʱηֱޣ
+ * һ򳬹ֵ˻С
+ */
+class AdaptiveSkip {
+public:
+/**
+ * @brief 캯
+ *
+ * @param min_skip С֡
+ * @param max_skip ֡
+ * @param threshold ƶȱȽֵ
+ */
+    AdaptiveSkip(int min_skip, int max_skip, int threshold)
+        : min_skip(std::max(1, min_skip)), max_skip(std::max(min_skip, max_skip)), threshold(threshold), skip(this->min_skip) {}
+
+/**
+ * @brief һ֡Ĺϣһ
+ *
+ * @param distance һ֡ĺ룬һ֡ -1
+ * @return int һ֡
+ */
+    int update(int distance) {
+        if (distance < 0 || distance >= threshold || distance > last_distance) {
+            skip = min_skip;
+        } else {
+            skip = std::min(skip * 2, max_skip);
+        }
+        last_distance = std::max(distance, 0);
+        return skip;
+    }
+
+private:
+    const int min_skip;     // С
+    const int max_skip;     // 
+    const int threshold;    // ƶȱȽֵ
+    int skip;               // ǰ
+    int last_distance = 0;  // һεĹϣ
+};
+
+/**
+ * @brief ̶ɿƺļƵв֡
+ *
+ * ˳ģʽֻڿʼʱλһΣ֮ grab() Ҫֻ֡Բ֡ retrieve()
+ * йؼ֡ʱһ֮֡ǰµĹؼ֡Ŷλ֡볬GOPʱλ
+ * ʱʱ㰴ʾʱ䣨CAP_PROP_POS_MSECŲ֡ grab() ֱԽʱ̣
+ * ڷ֡ʺͿɱ֡ʵƵ
+ */
+class FrameSampler {
+public:
+/**
+ * @brief 캯
+ *
+ * @param cap Ѵ򿪵Ƶ
+ * @param start_frame ʼ֡
+ * @param end_frame ֡
+ * @param frame_skip ֡
+ * @param sequential Ƿ˳
+ * @param gop_length GOPȣ֡˳ʱʹ
+ * @param limit_frame ֡ޣֶβʱڽضϸ
+ */
+    FrameSampler(cv::VideoCapture& cap, int start_frame, int end_frame, int frame_skip, bool sequential, double gop_length,
+                 int limit_frame = std::numeric_limits<int>::max())
+        : cap(cap), end_frame(end_frame), limit_frame(limit_frame), frame_skip(std::max(1, frame_skip)),
+          sequential(sequential), gop_length(gop_length), frame_index(start_frame) {}
+
+    // ùؼ֡ھ˳ʱʱλ
+    void set_keyframe_index(const KeyframeIndex* index) { keyframes = index; }
+
+    // òƺÿ֡ãм㲢дϣһ
+    void set_step_controller(std::function<int(SampledFrame&)> controller) { step_controller = std::move(controller); }
+
+/**
+ * @brief Ϊʾʱ˳룩
+ *
+ * @param start_msec ʼʱ䣨ms
+ * @param end_msec ʱ䣨ms<=0 ʾβ
+ * @param frame_msec һ֡ʱms֡˻Ϊʱ
+ */
+    void set_time_schedule(double start_msec, double end_msec, double frame_msec) {
+        next_msec = start_msec;
+        this->end_msec = end_msec;
+        this->frame_msec = frame_msec;
+    }
+
+/**
+ * @brief ֱδɫתYUVݣϣֻƽ棬BGRתҪ֡
+ *
+ * ֻӰϣ룬ı䱣ͼƬһֻ֡ƽ棨ɫȣʱĻBGR
+ *
+ * @return bool ǷܣʱBGR
+ */
+    bool request_raw_yuv() { return retriever.request_raw_yuv(); }
+
+/**
+ * @brief ȡһ֡
+ *
+ * @param sample 
+ * @return bool ѵ֡Ƶβʱ false
+ */
+    bool next(SampledFrame& sample) {
+        if (finished || frame_index >= limit_frame) return false;
+        bool grabbed = (frame_msec > 0) ? grab_by_time() : (seek_to(frame_index), cap.grab());
+        if (!grabbed || frame_index >= limit_frame || !retriever.retrieve(sample.frame)) {
+            finished = true;
+            return false;
+        }
+        sample.layout = retriever.pixel_layout();
+        sample.frame_index = frame_index;
+        sample.position = cap.get(cv::CAP_PROP_POS_FRAMES);
+        sample.timestamp = cap.get(cv::CAP_PROP_POS_MSEC);
+
+        if (sample.position >= end_frame || (end_msec > 0 && sample.timestamp >= end_msec)) {
+            finished = true;
+            return true;
+        }
+        int step = step_controller ? std::max(1, step_controller(sample)) : frame_skip;
+        frame_index += step;
+        if (frame_msec > 0) {
+            last_msec = sample.timestamp;
+            next_msec += step * frame_msec;
+            if (next_msec <= sample.timestamp) next_msec = sample.timestamp + step * frame_msec;
+        }
+        return true;
+    }
+
+private:
+/**
+ * @brief ʱ֡ grab() ֱʾʱ䵽һʱ̡
+ *
+ * @return bool Ƿõ֡ͬʱ frame_index
+ */
+    bool grab_by_time() {
+        if (!time_started) {
+            time_started = true;
+            if (next_msec > 0) cap.set(cv::CAP_PROP_POS_MSEC, next_msec);
+        } else if (cap.get(cv::CAP_PROP_POS_MSEC) < last_msec) {
+            cap.set(cv::CAP_PROP_POS_MSEC, next_msec); // ϸҳλʱ˻֮ǰλ
+        }
+        while (cap.grab()) {
+            // ֡ʱ뵼¶һ֡
+            if (cap.get(cv::CAP_PROP_POS_MSEC) + frame_msec / 2 >= next_msec) {
+                frame_index = int(cap.get(cv::CAP_PROP_POS_FRAMES)) - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+/**
+ * @brief ƶĿ֡ʹһ grab() õ֡
+ *
+ * ˳ʱӵǰλ֡ grab() ֻ벻תԽĿ꣨ϸҳλ֮
+ * мŹؼ֡ʱλ졣
+ *
+ * @param target Ŀ֡
+ */
+    void seek_to(int target) {
+        if (!sequential) {
+            cap.set(cv::CAP_PROP_POS_FRAMES, target);
+            return;
+        }
+        int position = int(cap.get(cv::CAP_PROP_POS_FRAMES));
+        if (position > target || should_seek(position, target)) {
+            cap.set(cv::CAP_PROP_POS_FRAMES, target);
+            return;
+        }
+        for (; position < target; ++position) {
+            if (!cap.grab()) break;
+        }
+    }
+
+/**
+ * @brief жϴӵǰλõĿ֡Ӧλ֡롣
+ *
+ * @param position һ֡
+ * @param target Ŀ֡
+ * @return bool Ƿλ
+ */
+    bool should_seek(int position, int target) const {
+        if (keyframes && keyframes->usable()) {
+            return keyframes->keyframe_at_or_before(target) > position;
+        }
+        return target - position + 1 > gop_length;
+    }
+
+    cv::VideoCapture& cap;
+    const int end_frame;      // ֡
+    const int limit_frame;    // ֡ޣ
+    const int frame_skip;     // ֡
+    const bool sequential;    // Ƿ˳
+    const double gop_length;  // GOPȣ֡
+    int frame_index;          // һ֡
+    bool finished = false;    // Ƿѽ
+    const KeyframeIndex* keyframes = nullptr; // ؼ֡Ϊ
+    std::function<int(SampledFrame&)> step_controller; // ƺΪ
+    double frame_msec = 0;                    // һ֡ʱms0ʱʱ
+    double next_msec = 0;                     // һʱ̣ms
+    double end_msec = 0;                      // ʱ䣨ms
+    double last_msec = 0;                     // һ֡ʱms
+    bool time_started = false;                // ʱǷѿʼ
+    FrameRetriever retriever{cap};            // ȡ֡ȷŲ
+};
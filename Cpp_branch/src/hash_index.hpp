@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "bk_tree.hpp"
+#include "hash_list.hpp"
+#include "hash_value.hpp"
+#include "multi_index.hpp"
+
+/**
+ * @brief ѱϣֵƲңѱԶѡṹ
+ *
+ * ʱ˳ɨ飨SIMDںһαȽ϶ϣһеĹϣһԽ
+ * öϣֵСʱÿűֻһϣʱֻ輸΢룻
+ * ָ루ֵܰӴ֣BKٸʱѱ졣л㰴 BenchIndex ʵѡȡ
+ */
+class HashIndex {
+public:
+    // öϣֵϴʱٵ˳ɨ죩
+    static constexpr size_t multi_index_size = 1024;
+    // BK
+    static constexpr size_t tree_size = 256;
+
+/**
+ * @brief 캯
+ *
+ * @param distance ϣ
+ * @param words ϣռõ64λֵţڶϣйϣжΪ0
+ */
+    explicit HashIndex(HashDistance distance = HashDistance::hamming(), const std::vector<int>& words = {0, 1, 2, 3})
+        : distance(distance), words(words), list(distance.words), tree(distance) {}
+
+    // һϣֵ
+    void insert(const FrameHash& hash) {
+        if (multi) {
+            multi->insert(hash);
+        } else if (!tree.empty()) {
+            tree.insert(hash);
+        } else {
+            list.push_back(hash);
+            if (list.size() >= (distance.tiled ? tree_size : multi_index_size)) build_index();
+        }
+    }
+
+/**
+ * @brief Ƿ hash ľС threshold Ĺϣֵ
+ *
+ * @param hash Ĺϣֵ
+ * @param threshold ƶȱȽֵ
+ * @return bool Ƿ
+ */
+    bool contains_within(const FrameHash& hash, int threshold) const {
+        if (multi) return multi->find_within(hash, threshold) >= 0;
+        if (!tree.empty()) return tree.find_within(hash, threshold) >= 0;
+        if (!distance.tiled) return list.find_within(hash, threshold) >= 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (distance(list.data(i), hash.words.data()) < threshold) return true;
+        }
+        return false;
+    }
+
+    size_t size() const { return multi ? multi->size() : tree.empty() ? list.size() : tree.size(); }
+
+private:
+    // ˳ŵĹϣ
+    void build_index() {
+        if (!distance.tiled) {
+            multi = std::make_unique<MultiIndex>(words);
+            multi->reserve(list.size() * 2);
+            for (size_t i = 0; i < list.size(); ++i) multi->insert(list[i]);
+        } else {
+            tree.reserve(list.size() * 2);
+            for (size_t i = 0; i < list.size(); ++i) tree.insert(list[i]);
+        }
+        list = HashList(distance.words);
+    }
+
+    HashDistance distance;             // ϣ
+    std::vector<int> words;            // ϣռõ64λ
+    HashList list;                     // ֮ǰĹϣֵ
+    std::unique_ptr<MultiIndex> multi; // 
+    BKTree tree;                       // 
+};
@@ -0,0 +1,819 @@
+#pragma once
+
+// ں˵ʵ֡ÿָķ뵥Ԫkernels*.cppһΣԲͬıѡ룬
+// ͨ CV_CPU_DISPATCH_MODE 벻ͬռ䣨OpenCVָͨͬ˷ cv::hal_<ָ>
+//
+// ͬڸ뵥ԪԲָͬ룬ʱֻһݣڲֵ֧CPUϱá
+// ĴֻܵñռڵĺOpenCVָͨC⺯ʹ std::vector
+// std::nth_element Ȼڴʵı׼ģ壬Ҳ cv::Mat ͷļе
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <opencv2/core/hal/intrin.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "kernels.hpp"
+
+#ifdef CV_CPU_DISPATCH_MODE
+#define KERNEL_NAMESPACE __CV_CAT(kernels_, CV_CPU_DISPATCH_MODE)
+#else
+#define KERNEL_NAMESPACE kernels_baseline
+#endif
+
+namespace KERNEL_NAMESPACE {
+
+// ߳ڸõĻֻҪʱ·
+template <typename T>
+class ScratchBuffer {
+public:
+    ~ScratchBuffer() { std::free(data); }
+    T* get(size_t n) {
+        if (n > size) {
+            std::free(data);
+            data = static_cast<T*>(std::malloc(n * sizeof(T)));
+            size = n;
+        }
+        return data;
+    }
+
+private:
+    T* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief 洢8λͼƽСΪ 3232 ĻҶͼζȡԴͼ񣩡
+ *
+ * ÿͼضӦԴͼһƽֵ߽ȡԴͼС32ʱظأ
+ * ߱Сʱ˫Բֵͨȷֱͣ weights ȨϳɻҶȣ
+ * BGRתҶȲҪؽУҲҪмͼ
+ *
+ * @param data Դͼ
+ * @param step мֽࣨڣ
+ * @param width ȣأ
+ * @param height ߶ȣأ
+ * @param channels ÿصֽ
+ * @param weights ͨĻҶȨ
+ * @param thumbnail ÷е 3232 float ȣ
+ * @param means ΪգΪʱͼظͨƽֵ3232channelsͨɫǩ
+ */
+inline void area_thumbnail(const uint8_t* data, size_t step, int width, int height, int channels, const float* weights,
+                           float* thumbnail, float* means) {
+    const int n = width * channels;            // һеֽ
+    const int max_rows = 257;                  // 16λۼۼӵ257  255 < 65536
+    thread_local ScratchBuffer<uint16_t> acc_buffer; // һڸеۼ
+    uint16_t* acc = acc_buffer.get(n);
+    uint32_t sums[thumbnail_size * 4];         // һڸͼصĸͨ
+    std::memset(acc, 0, n * sizeof(uint16_t));
+
+    // ͼÿжӦԴͼзΧ
+    int x_begin[thumbnail_size], x_end[thumbnail_size];
+    for (int c = 0; c < thumbnail_size; ++c) {
+        x_begin[c] = c * width / thumbnail_size < width - 1 ? c * width / thumbnail_size : width - 1;
+        x_end[c] = (c + 1) * width / thumbnail_size > x_begin[c] + 1 ? (c + 1) * width / thumbnail_size : x_begin[c] + 1;
+    }
+
+    // ۼзΧԼͼأۼ
+    auto flush = [&] {
+        for (int c = 0; c < thumbnail_size; ++c) {
+            uint32_t* cell = &sums[c * channels];
+            for (int x = x_begin[c] * channels; x < x_end[c] * channels; x += channels) {
+                for (int k = 0; k < channels; ++k) cell[k] += acc[x + k];
+            }
+        }
+        std::memset(acc, 0, n * sizeof(uint16_t));
+    };
+
+    for (int r = 0; r < thumbnail_size; ++r) {
+        int y_begin = r * height / thumbnail_size < height - 1 ? r * height / thumbnail_size : height - 1;
+        int y_end = (r + 1) * height / thumbnail_size > y_begin + 1 ? (r + 1) * height / thumbnail_size : y_begin + 1;
+        std::memset(sums, 0, sizeof(sums));
+
+        int rows = 0;
+        for (int y = y_begin; y < y_end; ++y) {
+            const uint8_t* row = data + size_t(y) * step;
+            int x = 0;
+#if CV_SIMD
+            for (; x <= n - cv::v_uint8::nlanes; x += cv::v_uint8::nlanes) {
+                cv::v_uint16 lo, hi;
+                cv::v_expand(cv::vx_load(row + x), lo, hi);
+                cv::v_store(acc + x, cv::vx_load(acc + x) + lo);
+                cv::v_store(acc + x + cv::v_uint16::nlanes, cv::vx_load(acc + x + cv::v_uint16::nlanes) + hi);
+            }
+#endif
+            for (; x < n; ++x) acc[x] += row[x];
+            if (++rows == max_rows) {
+                flush();
+                rows = 0;
+            }
+        }
+        flush();
+
+        float area = float(y_end - y_begin);
+        for (int c = 0; c < thumbnail_size; ++c) {
+            const uint32_t* cell = &sums[c * channels];
+            float gray = 0;
+            for (int k = 0; k < channels; ++k) gray += weights[k] * float(cell[k]);
+            float cell_area = area * float(x_end[c] - x_begin[c]);
+            thumbnail[r * thumbnail_size + c] = gray / cell_area;
+            if (means) {
+                float* mean = means + (r * thumbnail_size + c) * channels;
+                for (int k = 0; k < channels; ++k) mean[k] = float(cell[k]) / cell_area;
+            }
+        }
+    }
+}
+
+/**
+ * @brief жȡСΪ 169 ĿԤɸͼÿΪӦֽڵƽֵ
+ *
+ * @param data Դͼ
+ * @param step мֽࣨڣ
+ * @param width ȣأ
+ * @param height ߶ȣأ
+ * @param channels ÿصֽ
+ * @param tiny  169 ƽֵȣ
+ */
+inline void tiny_thumbnail(const uint8_t* data, size_t step, int width, int height, int channels, float* tiny) {
+    const int n = width * channels;
+    thread_local ScratchBuffer<uint32_t> sum_buffer; // һڸе
+    uint32_t* sums = sum_buffer.get(n);
+    for (int r = 0; r < tiny_rows; ++r) {
+        int y_begin = r * height / tiny_rows < height - 1 ? r * height / tiny_rows : height - 1;
+        int y_end = (r + 1) * height / tiny_rows > y_begin + 1 ? (r + 1) * height / tiny_rows : y_begin + 1;
+        std::memset(sums, 0, n * sizeof(uint32_t));
+        int rows = 0;
+        for (int y = y_begin; y < y_end; y += tiny_row_step, ++rows) {
+            const uint8_t* row = data + size_t(y) * step;
+            int x = 0;
+#if CV_SIMD
+            for (; x <= n - cv::v_uint8::nlanes; x += cv::v_uint8::nlanes) {
+                constexpr int quarter = cv::v_uint32::nlanes;
+                cv::v_uint16 lo, hi;
+                cv::v_expand(cv::vx_load(row + x), lo, hi);
+                cv::v_uint32 a, b, c, d;
+                cv::v_expand(lo, a, b);
+                cv::v_expand(hi, c, d);
+                cv::v_store(sums + x, cv::vx_load(sums + x) + a);
+                cv::v_store(sums + x + quarter, cv::vx_load(sums + x + quarter) + b);
+                cv::v_store(sums + x + 2 * quarter, cv::vx_load(sums + x + 2 * quarter) + c);
+                cv::v_store(sums + x + 3 * quarter, cv::vx_load(sums + x + 3 * quarter) + d);
+            }
+#endif
+            for (; x < n; ++x) sums[x] += row[x];
+        }
+        for (int c = 0; c < tiny_cols; ++c) {
+            int x_begin = (c * width / tiny_cols < width - 1 ? c * width / tiny_cols : width - 1) * channels;
+            int x_end = (c + 1) * width / tiny_cols * channels;
+            if (x_end < x_begin + channels) x_end = x_begin + channels;
+            uint64_t sum = 0;
+            for (int x = x_begin; x < x_end; ++x) sum += sums[x];
+            tiny[r * tiny_cols + c] = float(sum) / float(rows * (x_end - x_begin));
+        }
+    }
+}
+
+// ϣλӦıȽ64λ 88128λ 816256λ 1616
+template <int Bits>
+struct HashGrid;
+template <>
+struct HashGrid<64> { static constexpr int rows = 8, cols = 8; };
+template <>
+struct HashGrid<128> { static constexpr int rows = 8, cols = 16; };
+template <>
+struct HashGrid<256> { static constexpr int rows = 16, cols = 16; };
+
+// pHashౣĵƵDCTϵ256λʱΪ1616
+constexpr int dct_rows = 16;
+
+// ڼң̩չx ȹԼ [-, ]
+constexpr double constexpr_cos(double x) {
+    const double pi = 3.14159265358979323846;
+    while (x > pi) x -= 2 * pi;
+    while (x < -pi) x += 2 * pi;
+    double term = 1, sum = 1;
+    for (int n = 1; n < 30; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// ɵĳͨţʹ std::arrayԭļͷ
+template <int Size>
+struct ConstantTable {
+    float values[Size];
+
+    constexpr float& operator[](int i) { return values[i]; }
+    constexpr const float& operator[](int i) const { return values[i]; }
+};
+
+/**
+ * @brief 32DCT-IIǰ16У cv::dct һ£ȡ
+ *
+ * @return ConstantTable<dct_rows * thumbnail_size> basis[u * 32 + x] = a(u)cos((2x+1)u/64)
+ */
+constexpr ConstantTable<dct_rows * thumbnail_size> make_dct_basis() {
+    const double pi = 3.14159265358979323846;
+    const double a0 = 0.17677669529663688; // sqrt(1/32)
+    const double a1 = 0.25;                // sqrt(2/32)
+    ConstantTable<dct_rows * thumbnail_size> basis{};
+    for (int u = 0; u < dct_rows; ++u) {
+        for (int x = 0; x < thumbnail_size; ++x) {
+            basis[u * thumbnail_size + x] = float((u == 0 ? a0 : a1) * constexpr_cos(pi * (2 * x + 1) * u / (2 * thumbnail_size)));
+        }
+    }
+    return basis;
+}
+
+inline constexpr ConstantTable<dct_rows * thumbnail_size> dct_basis = make_dct_basis();
+
+/**
+ * @brief б任õתðżparity=0parity=1Ƶʵ8Уȡǰ16תΪ 168
+ *
+ * @param parity Ƶʵż
+ * @return ConstantTable<thumbnail_size / 2 * dct_rows / 2> half[x * 8 + k] = basis[(2k + parity) * 32 + x]
+ */
+constexpr ConstantTable<thumbnail_size / 2 * dct_rows / 2> make_half_basis(int parity) {
+    ConstantTable<thumbnail_size / 2 * dct_rows / 2> half{};
+    for (int x = 0; x < thumbnail_size / 2; ++x) {
+        for (int k = 0; k < dct_rows / 2; ++k) half[x * (dct_rows / 2) + k] = dct_basis[(2 * k + parity) * thumbnail_size + x];
+    }
+    return half;
+}
+
+inline constexpr ConstantTable<thumbnail_size / 2 * dct_rows / 2> dct_basis_even = make_half_basis(0);
+inline constexpr ConstantTable<thumbnail_size / 2 * dct_rows / 2> dct_basis_odd = make_half_basis(1);
+
+/**
+ * @brief ͼϽ RowsCols ƵDCTϵ cv::dct ĶӦͬ
+ *
+ * ȶ任 T = BXRows32ٶ任 D = TB^TRowsCols B ΪԤȼһ
+ * ûĶԳ B[u][31-y] = (-1)^uB[u][y]α任ֻۺ16
+ * ҲҪתʱͼ
+ *
+ * @tparam Rows ϵż16
+ * @tparam Cols ϵ816
+ * @param thumbnail 3232 ͼȣ
+ * @param coefficients  RowsCols ϵȣ
+ */
+template <int Rows, int Cols>
+inline void low_frequency_dct(const float* thumbnail, float* coefficients) {
+    static_assert(Rows % 2 == 0 && Rows <= dct_rows && (Cols == 8 || Cols == 16), "ֵ֧DCTϵΧ");
+    constexpr int n = thumbnail_size;
+    constexpr int half = thumbnail_size / 2;
+    constexpr int stride = dct_rows / 2; // תðг
+
+    // б任żƵʹ¶Գ֮ͣƵʹ֮
+    alignas(64) float t[Rows * n];
+#if CV_SIMD
+    for (int x = 0; x < n; x += cv::v_float32::nlanes) {
+        cv::v_float32 acc[Rows];
+        for (auto& a : acc) a = cv::vx_setzero_f32();
+        for (int y = 0; y < half; ++y) {
+            cv::v_float32 top = cv::vx_load(thumbnail + y * n + x);
+            cv::v_float32 bottom = cv::vx_load(thumbnail + (n - 1 - y) * n + x);
+            cv::v_float32 sum = top + bottom, diff = top - bottom;
+            for (int u = 0; u < Rows; u += 2) {
+                acc[u] = cv::v_fma(cv::vx_setall_f32(dct_basis[u * n + y]), sum, acc[u]);
+                acc[u + 1] = cv::v_fma(cv::vx_setall_f32(dct_basis[(u + 1) * n + y]), diff, acc[u + 1]);
+            }
+        }
+        for (int u = 0; u < Rows; ++u) cv::v_store(t + u * n + x, acc[u]);
+    }
+#else
+    for (int u = 0; u < Rows; ++u) {
+        for (int x = 0; x < n; ++x) {
+            float acc = 0;
+            for (int y = 0; y < half; ++y) {
+                float top = thumbnail[y * n + x], bottom = thumbnail[(n - 1 - y) * n + x];
+                acc += dct_basis[u * n + y] * (u % 2 ? top - bottom : top + bottom);
+            }
+            t[u * n + x] = acc;
+        }
+    }
+#endif
+
+    // б任żƵʸ Cols/2 ϵͬʱ
+    for (int u = 0; u < Rows; ++u) {
+        const float* tu = t + u * n;
+        float even[Cols / 2], odd[Cols / 2];
+#if CV_SIMD128
+        cv::v_float32x4 even_acc[Cols / 8], odd_acc[Cols / 8];
+        for (int g = 0; g < Cols / 8; ++g) even_acc[g] = odd_acc[g] = cv::v_setzero_f32();
+        for (int x = 0; x < half; ++x) {
+            cv::v_float32x4 sum = cv::v_setall_f32(tu[x] + tu[n - 1 - x]);
+            cv::v_float32x4 diff = cv::v_setall_f32(tu[x] - tu[n - 1 - x]);
+            for (int g = 0; g < Cols / 8; ++g) {
+                even_acc[g] = cv::v_fma(sum, cv::v_load(&dct_basis_even[x * stride + 4 * g]), even_acc[g]);
+                odd_acc[g] = cv::v_fma(diff, cv::v_load(&dct_basis_odd[x * stride + 4 * g]), odd_acc[g]);
+            }
+        }
+        for (int g = 0; g < Cols / 8; ++g) {
+            cv::v_store(even + 4 * g, even_acc[g]);
+            cv::v_store(odd + 4 * g, odd_acc[g]);
+        }
+#else
+        for (int k = 0; k < Cols / 2; ++k) {
+            even[k] = odd[k] = 0;
+            for (int x = 0; x < half; ++x) {
+                even[k] += (tu[x] + tu[n - 1 - x]) * dct_basis_even[x * stride + k];
+                odd[k] += (tu[x] - tu[n - 1 - x]) * dct_basis_odd[x * stride + k];
+            }
+        }
+#endif
+        for (int k = 0; k < Cols / 2; ++k) {
+            coefficients[u * Cols + 2 * k] = even[k];
+            coefficients[u * Cols + 2 * k + 1] = odd[k];
+        }
+    }
+}
+
+/**
+ * @brief ͼӵ y пʼ rows е͡
+ *
+ * @param thumbnail 3232 ͼ
+ * @param y ʼ
+ * @param rows 
+ * @param sums  32 к
+ */
+inline void band_sums(const float* thumbnail, int y, int rows, float* sums) {
+    const float* row = thumbnail + y * thumbnail_size;
+    int x = 0;
+#if CV_SIMD
+    for (; x < thumbnail_size; x += cv::v_float32::nlanes) {
+        cv::v_float32 sum = cv::vx_load(row + x);
+        for (int i = 1; i < rows; ++i) sum += cv::vx_load(row + i * thumbnail_size + x);
+        cv::v_store(sums + x, sum);
+    }
+#endif
+    for (; x < thumbnail_size; ++x) {
+        sums[x] = row[x];
+        for (int i = 1; i < rows; ++i) sums[x] += row[i * thumbnail_size + x];
+    }
+}
+
+/**
+ * @brief ͼƽΪ RowsCols 顣
+ *
+ * @param thumbnail 3232 ͼ
+ * @param blocks ֵȣ
+ */
+template <int Rows, int Cols>
+inline void grid_means(const float* thumbnail, float* blocks) {
+    constexpr int block_h = thumbnail_size / Rows, block_w = thumbnail_size / Cols;
+    float sums[thumbnail_size];
+    for (int r = 0; r < Rows; ++r) {
+        band_sums(thumbnail, r * block_h, block_h, sums);
+        for (int c = 0; c < Cols; ++c) {
+            float sum = 0;
+            for (int x = c * block_w; x < (c + 1) * block_w; ++x) sum += sums[x];
+            blocks[r * Cols + c] = sum / (block_h * block_w);
+        }
+    }
+}
+
+// Nֵλȡ N/2 Сֵ std::nth_element Ľͬѡ
+template <int N>
+inline float median_of(const float* values) {
+    float v[N];
+    for (int i = 0; i < N; ++i) v[i] = values[i];
+    int lo = 0, hi = N - 1;
+    const int k = N / 2;
+    while (lo < hi) {
+        float pivot = v[(lo + hi) / 2];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (v[i] < pivot) ++i;
+            while (v[j] > pivot) --j;
+            if (i <= j) {
+                float tmp = v[i];
+                v[i++] = v[j];
+                v[j--] = tmp;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+    return v[k];
+}
+
+//  Bits ȽϽдϣֵ i λڵ i / 64 ֵĵ 63 - i % 64 λλ㣩
+template <int Bits, typename Predicate>
+inline void pack_bits(Predicate bit, uint64_t* words) {
+    for (int w = 0; w < frame_hash_words; ++w) words[w] = 0;
+    for (int i = 0; i < Bits; ++i) {
+        if (bit(i)) words[i / 64] |= uint64_t(1) << (63 - i % 64);
+    }
+}
+
+/**
+ * @brief ϣ㷨ıѡHashAlgorithm<Kind>::compute<Bits>  3232 ͼ Bits λϣֵ
+ * Ƚ HashGrid<Bits> 
+ *
+ * @tparam Kind 㷨
+ */
+template <HashKind Kind>
+struct HashAlgorithm;
+
+template <>
+struct HashAlgorithm<HashKind::AHash> {
+    template <int Bits>
+    static void compute(const float* thumbnail, uint64_t* words) {
+        float blocks[Bits];
+        grid_means<HashGrid<Bits>::rows, HashGrid<Bits>::cols>(thumbnail, blocks);
+        float mean = 0;
+        for (float b : blocks) mean += b;
+        mean /= Bits;
+        pack_bits<Bits>([&](int i) { return blocks[i] > mean; }, words);
+    }
+};
+
+template <>
+struct HashAlgorithm<HashKind::DHash> {
+    template <int Bits>
+    static void compute(const float* thumbnail, uint64_t* words) {
+        // RowsС(Cols+1)еƽп߽绮
+        constexpr int rows = HashGrid<Bits>::rows, cols = HashGrid<Bits>::cols;
+        constexpr int block_h = thumbnail_size / rows;
+        float grid[rows][cols + 1], sums[thumbnail_size];
+        for (int r = 0; r < rows; ++r) {
+            band_sums(thumbnail, r * block_h, block_h, sums);
+            for (int c = 0; c <= cols; ++c) {
+                int x_begin = c * thumbnail_size / (cols + 1), x_end = (c + 1) * thumbnail_size / (cols + 1);
+                float sum = 0;
+                for (int x = x_begin; x < x_end; ++x) sum += sums[x];
+                grid[r][c] = sum / (block_h * (x_end - x_begin));
+            }
+        }
+        pack_bits<Bits>([&](int i) { return grid[i / cols][i % cols] > grid[i / cols][i % cols + 1]; }, words);
+    }
+};
+
+template <>
+struct HashAlgorithm<HashKind::PHash> {
+    template <int Bits>
+    static void compute(const float* thumbnail, uint64_t* words) {
+        float coefficients[Bits];
+        low_frequency_dct<HashGrid<Bits>::rows, HashGrid<Bits>::cols>(thumbnail, coefficients);
+        float mean = 0;
+        for (float c : coefficients) mean += c;
+        mean /= Bits;
+        pack_bits<Bits>([&](int i) { return coefficients[i] > mean; }, words);
+    }
+};
+
+template <>
+struct HashAlgorithm<HashKind::BlockMean> {
+    template <int Bits>
+    static void compute(const float* thumbnail, uint64_t* words) {
+        float blocks[Bits];
+        grid_means<HashGrid<Bits>::rows, HashGrid<Bits>::cols>(thumbnail, blocks);
+        float median = median_of<Bits>(blocks);
+        pack_bits<Bits>([&](int i) { return blocks[i] > median; }, words);
+    }
+};
+
+template <>
+struct HashAlgorithm<HashKind::Haar> {
+    template <int Bits>
+    static void compute(const float* thumbnail, uint64_t* words) {
+        // ֵһάHaarֽ⣺LLHLLHHH ռķ֮һ˳
+        constexpr int rows = HashGrid<Bits>::rows, cols = HashGrid<Bits>::cols;
+        constexpr int quarter = Bits / 4;
+        float blocks[Bits], bands[Bits];
+        grid_means<rows, cols>(thumbnail, blocks);
+        for (int r = 0; r < rows / 2; ++r) {
+            for (int c = 0; c < cols / 2; ++c) {
+                float a = blocks[(2 * r) * cols + 2 * c], b = blocks[(2 * r) * cols + 2 * c + 1];
+                float d = blocks[(2 * r + 1) * cols + 2 * c], e = blocks[(2 * r + 1) * cols + 2 * c + 1];
+                int i = r * (cols / 2) + c;
+                bands[i] = (a + b + d + e) / 4;
+                bands[quarter + i] = (a - b + d - e) / 4;
+                bands[2 * quarter + i] = (a + b - d - e) / 4;
+                bands[3 * quarter + i] = (a - b - d + e) / 4;
+            }
+        }
+        // ƵλȽϣƵȡţɫΪ0
+        float median = median_of<quarter>(bands);
+        pack_bits<Bits>([&](int i) { return i < quarter ? bands[i] > median : bands[i] > 0; }, words);
+    }
+};
+
+// ѡĹϣ
+template <HashKind Kind, int Bits>
+inline void compute_hash(const float* thumbnail, uint64_t* words) {
+    HashAlgorithm<Kind>::template compute<Bits>(thumbnail, words);
+}
+
+/**
+ * @brief pHash HashAlgorithm<PHash> ͬÿͨһͼ
+ * ҪŵˮƽԼ͹㲥
+ *
+ * @tparam Rows ϵ
+ * @tparam Cols ϵ
+ * @param data ṹ飬 p صĸͼֵ data[p * stride] ʼ
+ * @param stride ÿλõͨȵı
+ * @param count ͼ
+ * @param words count ϣֵÿ frame_hash_words 
+ */
+template <int Rows, int Cols>
+inline void phash_batch(const float* data, int stride, int count, uint64_t* words) {
+    constexpr int n = thumbnail_size;
+    constexpr int half = thumbnail_size / 2;
+    constexpr int bits = Rows * Cols;
+#if CV_SIMD
+    using vec = cv::v_float32;
+    constexpr int lanes = vec::nlanes;
+    auto splat = [](float v) { return cv::vx_setall_f32(v); };
+    auto zero = [] { return cv::vx_setzero_f32(); };
+    auto fma = [](const vec& a, const vec& b, const vec& c) { return cv::v_fma(a, b, c); };
+#else
+    using vec = float;
+    constexpr int lanes = 1;
+    auto splat = [](float v) { return v; };
+    auto zero = [] { return 0.0f; };
+    auto fma = [](float a, float b, float c) { return a * b + c; };
+#endif
+    constexpr int rows = Rows > Cols ? Rows : Cols;
+    // Ԥȹ㲥һֻõǰ16У
+    vec basis[rows][half];
+    for (int u = 0; u < rows; ++u) {
+        for (int y = 0; y < half; ++y) basis[u][y] = splat(dct_basis[u * n + y]);
+    }
+
+    for (int g = 0; g < count; g += lanes) {
+#if CV_SIMD
+        auto load = [&](int p) { return cv::vx_load(data + size_t(p) * stride + g); };
+#else
+        auto load = [&](int p) { return data[size_t(p) * stride + g]; };
+#endif
+        // б任жȡżƵʹ¶Գ֮ͣƵʹ֮
+        vec t[Rows][n];
+        for (int x = 0; x < n; ++x) {
+            vec sum[half], diff[half];
+            for (int y = 0; y < half; ++y) {
+                vec top = load(y * n + x), bottom = load((n - 1 - y) * n + x);
+                sum[y] = top + bottom;
+                diff[y] = top - bottom;
+            }
+            for (int u = 0; u < Rows; ++u) {
+                const vec* folded = (u % 2) ? diff : sum;
+                vec acc = zero();
+                for (int y = 0; y < half; ++y) acc = fma(basis[u][y], folded[y], acc);
+                t[u][x] = acc;
+            }
+        }
+
+        // б任
+        vec coefficients[bits];
+        vec mean = zero();
+        for (int u = 0; u < Rows; ++u) {
+            vec sum[half], diff[half];
+            for (int x = 0; x < half; ++x) {
+                sum[x] = t[u][x] + t[u][n - 1 - x];
+                diff[x] = t[u][x] - t[u][n - 1 - x];
+            }
+            for (int v = 0; v < Cols; ++v) {
+                const vec* folded = (v % 2) ? diff : sum;
+                vec acc = zero();
+                for (int x = 0; x < half; ++x) acc = fma(basis[v][x], folded[x], acc);
+                coefficients[u * Cols + v] = acc;
+                mean = mean + acc;
+            }
+        }
+        mean = mean * splat(1.0f / bits);
+
+        // λȽϣÿͨıȽϽдӦĹϣֵ
+        int valid = count - g < lanes ? count - g : lanes;
+        uint64_t* out = words + size_t(g) * frame_hash_words;
+        std::memset(out, 0, size_t(valid) * frame_hash_words * sizeof(uint64_t));
+        for (int i = 0; i < bits; ++i) {
+#if CV_SIMD
+            int mask = cv::v_signmask(coefficients[i] > mean);
+#else
+            int mask = coefficients[i] > mean ? 1 : 0;
+#endif
+            for (int l = 0; l < valid; ++l) {
+                if ((mask >> l) & 1) out[l * frame_hash_words + i / 64] |= uint64_t(1) << (63 - i % 64);
+            }
+        }
+    }
+}
+
+/**
+ * @brief ָϣһ16λϣ44ֵ뱾λȽϡ
+ *
+ * ÿʹԼλĳһֵᱻֵݳ嵭
+ *
+ * @param thumbnail ø 3232 ͼ
+ * @return uint16_t ϣֵ0λ
+ */
+inline uint16_t tile_hash(const float* thumbnail) {
+    float blocks[16];
+    grid_means<4, 4>(thumbnail, blocks);
+    float median = median_of<16>(blocks);
+    uint16_t hash = 0;
+    for (int i = 0; i < 16; ++i) hash = uint16_t((hash << 1) | (blocks[i] > median ? 1 : 0));
+    return hash;
+}
+
+// 64λ1λPOPCNTָʱΪָ
+inline int popcount64(uint64_t x) {
+#if CV_POPCNT
+    return int(_mm_popcnt_u64(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return int((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief ϣĺ롣
+ *
+ * ֧AVX-512 VPOPCNTDQʱ256λĹϣһμPOPCNTʱּSIMDֽڼ͡
+ *
+ * @tparam Words ÿϣ12  4
+ * @param a ϣֵ
+ * @param b ϣֵ
+ * @return int ͬλ
+ */
+template <int Words>
+inline int hamming_distance(const uint64_t* a, const uint64_t* b) {
+#if CV_AVX_512VPOPCNTDQ && CV_AVX_512VL
+    if constexpr (Words == 4) {
+        __m256i diff = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+        __m256i counts = _mm256_popcnt_epi64(diff);
+        __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+        return int(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+    }
+#elif !CV_POPCNT && CV_SIMD128
+    if constexpr (Words > 1) {
+        const uint8_t* pa = reinterpret_cast<const uint8_t*>(a);
+        const uint8_t* pb = reinterpret_cast<const uint8_t*>(b);
+        cv::v_uint8x16 counts = cv::v_setzero_u8();
+        for (int i = 0; i < Words * 8; i += 16) counts += cv::v_popcount(cv::v_load(pa + i) ^ cv::v_load(pb + i));
+        return int(cv::v_reduce_sum(counts));
+    }
+#endif
+    int distance = 0;
+    for (int i = 0; i < Words; ++i) distance += popcount64(a[i] ^ b[i]);
+    return distance;
+}
+
+/**
+ * @brief ָϣľ룺16λֵ
+ *
+ * @param a ָϣframe_hash_words ֣
+ * @param b ָϣ
+ * @return int 仯һĺ
+ */
+inline int tile_distance(const uint64_t* a, const uint64_t* b) {
+    int worst = 0;
+    for (int w = 0; w < frame_hash_words; ++w) {
+        uint64_t diff = a[w] ^ b[w];
+        for (int k = 0; k < 64; k += 16) {
+            int d = popcount64((diff >> k) & 0xFFFF);
+            worst = d > worst ? d : worst;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief ŵĹϣвҵһ query ĺС threshold Ĺϣҵء
+ *
+ * AVX-512 VPOPCNTDQ ÿ512λȡȽ 8/Words ϣAVX2 òpshufbֽڼÿαȽ4ϣ
+ *  hamming_distance
+ *
+ * @tparam Words ÿϣ12  4
+ * @param hashes ϣ飬ÿϣռ Words 
+ * @param count ϣ
+ * @param query ҵĹϣWords ֣
+ * @param threshold ޣ
+ * @return int ţûʱ -1
+ */
+template <int Words>
+inline int find_within(const uint64_t* hashes, int count, const uint64_t* query, int threshold) {
+    int i = 0;
+#if CV_AVX512_SKX && CV_AVX_512VPOPCNTDQ
+    const __m512i limit = _mm512_set1_epi64(threshold);
+    if constexpr (Words == 1) {
+        const __m512i q = _mm512_set1_epi64(int64_t(query[0]));
+        for (; i + 8 <= count; i += 8) {
+            __m512i p = _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(hashes + i), q));
+            unsigned hits = _mm512_cmplt_epi64_mask(p, limit);
+            if (hits) return i + __builtin_ctz(hits);
+        }
+    } else if constexpr (Words == 2) {
+        const __m512i q = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(query)));
+        for (; i + 4 <= count; i += 4) {
+            __m512i p = _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(hashes + size_t(i) * 2), q));
+            // ͬһϣһӣżλõ64λΪ4ϣľ
+            __m512i sums = _mm512_add_epi64(p, _mm512_shuffle_epi32(p, _MM_PERM_BADC));
+            unsigned hits = _mm512_cmplt_epi64_mask(sums, limit) & 0x55;
+            if (hits) return i + __builtin_ctz(hits) / 2;
+        }
+    } else {
+        const __m512i q = _mm512_broadcast_i64x4(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(query)));
+        const __m512i order = _mm512_setr_epi64(0, 4, 1, 5, 2, 6, 3, 7);
+        for (; i + 4 <= count; i += 4) {
+            const uint64_t* h = hashes + size_t(i) * Words;
+            __m512i p0 = _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(h), q));     //  ii+1 
+            __m512i p1 = _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(h + 8), q)); //  i+2i+3 
+            // Ӻڵ128λӣ041564λΪ4ϣľ
+            __m512i sums = _mm512_add_epi64(_mm512_unpacklo_epi64(p0, p1), _mm512_unpackhi_epi64(p0, p1));
+            sums = _mm512_add_epi64(sums, _mm512_shuffle_i64x2(sums, sums, _MM_SHUFFLE(2, 3, 0, 1)));
+            unsigned hits = _mm512_cmplt_epi64_mask(_mm512_permutexvar_epi64(order, sums), limit) & 0xF;
+            if (hits) return i + __builtin_ctz(hits);
+        }
+    }
+#elif CV_AVX2
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    const __m256i limit = _mm256_set1_epi64x(threshold);
+    __m256i q;
+    if constexpr (Words == 1) {
+        q = _mm256_set1_epi64x(int64_t(query[0]));
+    } else if constexpr (Words == 2) {
+        q = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(query)));
+    } else {
+        q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(query));
+    }
+    // 256λи query Ӧֵľ
+    auto word_distances = [&](const uint64_t* h) {
+        __m256i diff = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h)), q);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(diff, low_nibble)),
+                                        _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(diff, 4), low_nibble)));
+        return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+    };
+    for (; i + 4 <= count; i += 4) {
+        const uint64_t* h = hashes + size_t(i) * Words;
+        __m256i sums;
+        if constexpr (Words == 1) {
+            sums = word_distances(h);
+        } else if constexpr (Words == 2) {
+            // Ӻ64λΪ ii+2i+1i+3 ϣľ
+            __m256i p0 = word_distances(h), p1 = word_distances(h + 4);
+            sums = _mm256_add_epi64(_mm256_unpacklo_epi64(p0, p1), _mm256_unpackhi_epi64(p0, p1));
+            sums = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 1, 2, 0));
+        } else {
+            __m256i p0 = word_distances(h), p1 = word_distances(h + 4);
+            __m256i p2 = word_distances(h + 8), p3 = word_distances(h + 12);
+            // ӣٰǰ128λӣõ4ϣľ
+            __m256i s01 = _mm256_add_epi64(_mm256_unpacklo_epi64(p0, p1), _mm256_unpackhi_epi64(p0, p1));
+            __m256i s23 = _mm256_add_epi64(_mm256_unpacklo_epi64(p2, p3), _mm256_unpackhi_epi64(p2, p3));
+            sums = _mm256_add_epi64(_mm256_permute2x128_si256(s01, s23, 0x20), _mm256_permute2x128_si256(s01, s23, 0x31));
+        }
+        int hits = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, sums)));
+        if (hits) return i + __builtin_ctz(hits);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (hamming_distance<Words>(hashes + size_t(i) * Words, query) < threshold) return i;
+    }
+    return -1;
+}
+
+// λѡĹϣ㺯
+template <HashKind Kind>
+inline void fill_hash_functions(HashKernels& kernels) {
+    kernels.hash[int(Kind)][0] = compute_hash<Kind, 64>;
+    kernels.hash[int(Kind)][1] = compute_hash<Kind, 128>;
+    kernels.hash[int(Kind)][2] = compute_hash<Kind, 256>;
+}
+
+// ָں˱
+inline HashKernels make_kernels(const char* name) {
+    HashKernels kernels{};
+    kernels.name = name;
+    kernels.area_thumbnail = area_thumbnail;
+    kernels.tiny_thumbnail = tiny_thumbnail;
+    fill_hash_functions<HashKind::AHash>(kernels);
+    fill_hash_functions<HashKind::DHash>(kernels);
+    fill_hash_functions<HashKind::PHash>(kernels);
+    fill_hash_functions<HashKind::BlockMean>(kernels);
+    fill_hash_functions<HashKind::Haar>(kernels);
+    kernels.phash_batch[0] = phash_batch<8, 8>;
+    kernels.phash_batch[1] = phash_batch<8, 16>;
+    kernels.phash_batch[2] = phash_batch<16, 16>;
+    kernels.tile_hash = tile_hash;
+    kernels.hamming_distance[0] = hamming_distance<1>;
+    kernels.hamming_distance[1] = hamming_distance<2>;
+    kernels.hamming_distance[2] = hamming_distance<4>;
+    kernels.tile_distance = tile_distance;
+    kernels.find_within[0] = find_within<1>;
+    kernels.find_within[1] = find_within<2>;
+    kernels.find_within[2] = find_within<4>;
+    return kernels;
+}
+
+} // namespace KERNEL_NAMESPACE
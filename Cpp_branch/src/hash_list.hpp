@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "hash_value.hpp"
+#include "kernels.hpp"
+
+// У64ֽڣķʹɨʱÿ512λȡ绺
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t alignment{64};
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), alignment)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, alignment); }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+/**
+ * @brief ѱĹϣֵڰжС
+ *
+ * ÿϣֻűʵռõǰ words ֣12  464λϣÿֻռ8ֽڣ˳ɨȡڴ١
+ * ɰCPUѡĶӦȵںˣHashKernels::find_withinһαȽ϶ϣҵһƵļء
+ */
+class HashList {
+public:
+/**
+ * @brief 캯
+ *
+ * @param words ÿϣռõ hash_storage_words ȡΪ124йϣжΪ0
+ */
+    explicit HashList(int words = frame_hash_words) : words(hash_storage_words(words)) {}
+
+    void push_back(const FrameHash& hash) { storage.insert(storage.end(), hash.words.begin(), hash.words.begin() + words); }
+    size_t size() const { return storage.size() / words; }
+    bool empty() const { return storage.empty(); }
+    void reserve(size_t count) { storage.reserve(count * words); }
+
+    //  i ϣĸ
+    const uint64_t* data(size_t i) const { return storage.data() + i * words; }
+
+    //  i ϣչΪ FrameHash
+    FrameHash operator[](size_t i) const {
+        FrameHash hash;
+        std::copy(data(i), data(i) + words, hash.words.begin());
+        return hash;
+    }
+
+/**
+ * @brief ҵһ hash ĺС threshold Ĺϣ
+ *
+ * @param hash ҵĹϣ
+ * @param threshold ޣ
+ * @return int ţûʱ -1
+ */
+    int find_within(const FrameHash& hash, int threshold) const {
+        if (storage.empty()) return -1;
+        return cpu_kernels().find_within[hash_width_index(words * 64)](storage.data(), int(size()), hash.words.data(),
+                                                                        threshold);
+    }
+
+private:
+    int words;                                                     // ÿϣ
+    std::vector<uint64_t, CacheAlignedAllocator<uint64_t>> storage; // ϣǰ words ֣δ
+};
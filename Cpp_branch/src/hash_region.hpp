@@ -0,0 +1,135 @@
+#pragma once
+
+#include <opencv2/imgproc.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "phash.hpp"
+
+/**
+ * @brief б "x,y,,;x,y,,;..."
+ *
+ * @param text ıΪʱõб
+ * @param rects ʽЧʱ
+ * @return bool ʽǷЧ
+ */
+inline bool parse_rects(const std::string& text, std::vector<cv::Rect>& rects) {
+    std::vector<cv::Rect> parsed;
+    std::istringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ';')) {
+        if (item.find_first_not_of(" \t") == std::string::npos) continue;
+        std::istringstream in(item);
+        cv::Rect rect;
+        char c1 = 0, c2 = 0, c3 = 0;
+        if (!(in >> rect.x >> c1 >> rect.y >> c2 >> rect.width >> c3 >> rect.height) || c1 != ',' || c2 != ',' || c3 != ','
+            || rect.width <= 0 || rect.height <= 0) {
+            return false;
+        }
+        parsed.push_back(rect);
+    }
+    rects = std::move(parsed);
+    return true;
+}
+
+/**
+ * @brief ϣʱʹõĻ򣺿ֻȡһ֣ROIųлʱӡȻ仯Ĳ֡
+ *
+ * ROIС֮ǰüزȡų򣨾λͼΪ0Ĳ֣ڴʱӳ䵽
+ * 3232 ͼĵԪϣųصĵԪ൥Ԫľֵ䣬Щֵı仯Ӱϣֵ
+ * ͬӳ䵽Ԥɸ 169 ͼϣ ChangeFilter Щӡ
+ */
+class HashRegion {
+public:
+    HashRegion() = default;
+
+/**
+ * @brief 캯
+ *
+ * @param frame_size ߴ
+ * @param roi ʹõΪʱʹ
+ * @param exclusions ųľΣ꣩
+ * @param mask ͼ0 ʾųŵߴʹãΪ
+ */
+    HashRegion(cv::Size frame_size, const cv::Rect& roi, const std::vector<cv::Rect>& exclusions, const cv::Mat& mask) {
+        cv::Rect frame(cv::Point(0, 0), frame_size);
+        this->roi = roi.empty() ? frame : (roi & frame);
+        if (this->roi.empty()) this->roi = frame;
+        if (exclusions.empty() && mask.empty()) return;
+
+        // ϱ
+        cv::Mat keep(frame_size, CV_8U, cv::Scalar(255));
+        for (const auto& rect : exclusions) keep(rect & frame).setTo(0);
+        if (!mask.empty()) {
+            cv::Mat scaled;
+            cv::resize(mask, scaled, frame_size, 0, 0, cv::INTER_NEAREST);
+            keep.setTo(0, scaled == 0);
+        }
+
+        cv::Mat kept = keep(this->roi);
+        excluded = excluded_cells(kept, thumbnail_size, thumbnail_size);
+        tiny_excluded = excluded_cells(kept, tiny_rows, tiny_cols);
+    }
+
+/**
+ * @brief ڵĹϣͼ
+ *
+ * @param raw 
+ * @param layout Ų
+ * @param thumbnail 3232 ͼ
+ * @param chroma ΪգΪʱ 3232 ɫͼųĵԪΪ0
+ */
+    void make_thumbnail(const cv::Mat& raw, PixelLayout layout, float* thumbnail, float* chroma = nullptr) const {
+        ::make_thumbnail(raw, layout, thumbnail, roi, chroma);
+        if (excluded.empty()) return;
+
+        float sum = 0;
+        int count = 0;
+        for (int i = 0; i < thumbnail_size * thumbnail_size; ++i) {
+            if (!excluded[i]) {
+                sum += thumbnail[i];
+                count++;
+            }
+        }
+        float mean = count ? sum / count : 0; // ȫųʱΪ
+        for (int i = 0; i < thumbnail_size * thumbnail_size; ++i) {
+            if (!excluded[i]) continue;
+            thumbnail[i] = mean;
+            if (chroma) chroma[i] = 0;
+        }
+    }
+
+    // ʹõѲüڣ
+    const cv::Rect& area() const { return roi; }
+
+    // ԤɸͼбųĸӣȣΪʱûų
+    const std::vector<uint8_t>& tiny_exclusions() const { return tiny_excluded; }
+
+private:
+    // Сںͬı߽Ϊ rowscols ųصĸΪ1ûصʱؿ
+    static std::vector<uint8_t> excluded_cells(const cv::Mat& kept, int rows, int cols) {
+        int width = kept.cols, height = kept.rows;
+        std::vector<uint8_t> cells(rows * cols, 0);
+        int excluded_count = 0;
+        for (int r = 0; r < rows; ++r) {
+            int y_begin = std::min(r * height / rows, height - 1);
+            int y_end = std::max(y_begin + 1, (r + 1) * height / rows);
+            for (int c = 0; c < cols; ++c) {
+                int x_begin = std::min(c * width / cols, width - 1);
+                int x_end = std::max(x_begin + 1, (c + 1) * width / cols);
+                cv::Rect cell(x_begin, y_begin, x_end - x_begin, y_end - y_begin);
+                if (cv::countNonZero(kept(cell)) < cell.area()) {
+                    cells[r * cols + c] = 1;
+                    excluded_count++;
+                }
+            }
+        }
+        if (excluded_count == 0) cells.clear();
+        return cells;
+    }
+
+    cv::Rect roi;                       // ʹõΪʱʹ
+    std::vector<uint8_t> excluded;      // ųͼԪΪʱûų
+    std::vector<uint8_t> tiny_excluded; // ųĿԤɸӣΪʱûų
+};
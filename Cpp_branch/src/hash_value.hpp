@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "kernels.hpp"
+
+/**
+ * @brief ֪ϣֵ64λ洢
+ *
+ *  i λȱţ words[i / 64] ĵ 63 - i % 64 λ
+ * 64λϣֵԭ size_t ϣλǰŲͬ
+ *
+ * @tparam Bits λ64128  256
+ */
+template <int Bits>
+struct Hash {
+    static_assert(Bits == 64 || Bits == 128 || Bits == 256, "ϣλֻΪ64128256");
+    static constexpr int bits = Bits;
+    static constexpr int word_count = Bits / 64;
+
+    alignas(16) std::array<uint64_t, word_count> words{};
+
+    void set(int i) { words[i / 64] |= uint64_t(1) << (63 - i % 64); }
+    bool test(int i) const { return (words[i / 64] >> (63 - i % 64)) & 1; }
+    bool operator==(const Hash& other) const { return words == other.words; }
+    bool operator!=(const Hash& other) const { return words != other.words; }
+
+    // չΪĹϣλ㣨㲿ֲӰ캺룩
+    template <int Wider>
+    Hash<Wider> widen() const {
+        static_assert(Wider >= Bits, "ֻչΪĹϣ");
+        Hash<Wider> wide;
+        for (int i = 0; i < word_count; ++i) wide.words[i] = words[i];
+        return wide;
+    }
+};
+
+// ˮдݵĹϣλĹϣչΪ256λʹʱλ
+// ͱȽʱֻʹñʵռõ֣ HashDistanceĬϵ64λģʽÿϣֻźͱȽһ֡
+using FrameHash = Hash<256>;
+
+static_assert(FrameHash::word_count == frame_hash_words && sizeof(FrameHash) == frame_hash_words * sizeof(uint64_t),
+              "ں˰64λֶд FrameHash");
+
+/**
+ * @brief  FrameHash ĺ루ɰCPUѡں˼㣬Ƚȫ256λ
+ *
+ * @param a ϣֵ
+ * @param b ϣֵ
+ * @return int ͬλ
+ */
+inline int hamming_distance(const FrameHash& a, const FrameHash& b) {
+    return cpu_kernels().hamming_distance[hash_width_index(FrameHash::bits)](a.words.data(), b.words.data());
+}
+
+/**
+ * @brief ϣֵľ루ָ룬ǲʽ
+ *
+ * ֻȽϱеĹϣʵռõǰ words ֣֮йϣжΪ064λϣֻȡͱȽһ֣
+ * ѱϣĸֽṹHashListBKTreeMultiIndexPersistentIndexҲ words ִÿϣ
+ */
+struct HashDistance {
+    int (*kernel)(const uint64_t* a, const uint64_t* b) = nullptr; // Ƚ words ֵں
+    int words = frame_hash_words; // ÿϣźͱȽϵ12  4
+    bool tiled = false;           // ǷΪָ루ֵܰӴ֣
+
+    // Ƚǰ words ֣12  4ĺ
+    static HashDistance hamming(int words = frame_hash_words) {
+        HashDistance distance;
+        distance.words = hash_storage_words(words);
+        distance.kernel = cpu_kernels().hamming_distance[hash_width_index(distance.words * 64)];
+        return distance;
+    }
+
+    // ָ룬Ƚȫ frame_hash_words ֣ tile_hash.hpp
+    static HashDistance tiles() {
+        HashDistance distance;
+        distance.kernel = cpu_kernels().tile_distance;
+        distance.tiled = true;
+        return distance;
+    }
+
+    int operator()(const uint64_t* a, const uint64_t* b) const { return kernel(a, b); }
+    int operator()(const FrameHash& a, const FrameHash& b) const { return kernel(a.words.data(), b.words.data()); }
+};
@@ -0,0 +1,71 @@
+// ָx86-64SSE2ںˣԼʱںѡ
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "hash_kernels.hpp"
+
+const HashKernels& baseline_kernels() {
+    static const HashKernels kernels = KERNEL_NAMESPACE::make_kernels("baseline");
+    return kernels;
+}
+
+namespace {
+
+// һָں˼CPUǷ֧
+struct KernelLevel {
+    const HashKernels& (*kernels)();
+    bool (*supported)();
+};
+
+bool cpu_supports_sse42() {
+    return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+}
+
+bool cpu_supports_avx2() {
+    return cpu_supports_sse42() && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+bool cpu_supports_avx512() {
+    return cpu_supports_avx2() && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd")
+        && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")
+        && __builtin_cpu_supports("avx512vpopcntdq");
+}
+
+// ɵ͵еĸָ
+const KernelLevel levels[] = {
+    {baseline_kernels, [] { return true; }},
+    {sse42_kernels, cpu_supports_sse42},
+    {avx2_kernels, cpu_supports_avx2},
+    {avx512_kernels, cpu_supports_avx512},
+};
+
+// ѡCPUֵָ֧ PV2I_KERNELS ָϵ͵ָ
+const HashKernels& select_kernels() {
+    __builtin_cpu_init();
+    const char* requested = std::getenv("PV2I_KERNELS");
+    const HashKernels* best = &baseline_kernels();
+    for (const auto& level : levels) {
+        if (!level.supported()) break;
+        best = &level.kernels();
+        if (requested && std::strcmp(requested, best->name) == 0) break;
+    }
+    return *best;
+}
+
+} // namespace
+
+const HashKernels& cpu_kernels() {
+    static const HashKernels& kernels = select_kernels();
+    return kernels;
+}
+
+std::vector<const HashKernels*> available_kernels() {
+    __builtin_cpu_init();
+    std::vector<const HashKernels*> result;
+    for (const auto& level : levels) {
+        if (!level.supported()) break;
+        result.push_back(&level.kernels());
+    }
+    return result;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ϣͼı߳أ
+constexpr int thumbnail_size = 32;
+
+// ˮдݵĹϣFrameHash256λ
+constexpr int frame_hash_words = 4;
+
+// Ԥɸͼĳߴ磨16:9
+constexpr int tiny_cols = 16;
+constexpr int tiny_rows = 9;
+
+// Ԥɸжȡоֻ࣬ȡԴͼķ֮һ
+constexpr int tiny_row_step = 4;
+
+// ֪ϣ㷨
+enum class HashKind {
+    AHash,     // ֵϣֵֵܾȽ
+    DHash,     // ֵϣһеֵˮƽݶȷ
+    PHash,     // ֪ϣƵDCTϵֵȽ
+    BlockMean, // ֵϣֵλȽ
+    Haar,      // HaarСϣֵһHaarֽ⣬ƵλȽϡƵȡ
+};
+
+// 㷨
+constexpr int hash_kind_count = 5;
+
+// ϣλں˱еţ64λΪ0128λΪ1256λΪ2
+constexpr int hash_width_index(int bits) { return bits == 256 ? 2 : bits == 128 ? 1 : 0; }
+
+//  used ֣ϣɫǩʱÿϣռõ12  4ں˵Ŀͬ
+constexpr int hash_storage_words(int used) { return used <= 1 ? 1 : used == 2 ? 2 : frame_hash_words; }
+
+/**
+ * @brief һ鰴ͬһָļںˡ
+ *
+ * ÿָx86-64SSE4.2AVX2AVX-512ںڵķ뵥ԪԶӦıѡ룬
+ * ʱCPUֵָ֧ѡһ飬ͬһִļ¾ɲͬĻ϶ӳȡ
+ * ӿֻʹûͣϣʱ frame_hash_words 64λִݣ FrameHash Ĵ洢ͬ
+ * ȽʱеĹϣʵռõ12  4 hash_storage_wordsѡںˣ64λϣֻȡͱȽһ֡
+ */
+struct HashKernels {
+    const char* name; // ָ
+
+    // ƽСΪ 3232 Ҷͼmeans ΪʱͬʱԪͨƽֵ area_thumbnail
+    void (*area_thumbnail)(const uint8_t* data, size_t step, int width, int height, int channels, const float* weights,
+                           float* thumbnail, float* means);
+
+    // жȡСΪ 169 ĿԤɸͼֽڵƽֵ
+    void (*tiny_thumbnail)(const uint8_t* data, size_t step, int width, int height, int channels, float* tiny);
+
+    // ͼϣhash[㷨][λ]λд frame_hash_words 
+    void (*hash[hash_kind_count][3])(const float* thumbnail, uint64_t* words);
+
+    // pHashdata Ϊṹ飨 p صĸͼţ strideд count ϣֵ
+    void (*phash_batch[3])(const float* data, int stride, int count, uint64_t* words);
+
+    // ָϣһ16λϣ
+    uint16_t (*tile_hash)(const float* thumbnail);
+
+    // ϣĺ룺hamming_distance[λ]Ƚ 12  4 
+    int (*hamming_distance[3])(const uint64_t* a, const uint64_t* b);
+
+    // ָϣframe_hash_words ֣б仯һĺ
+    int (*tile_distance)(const uint64_t* a, const uint64_t* b);
+
+    // ŵ count ϣвҵһС threshold ģţûʱ -1
+    // find_within[λ]ÿϣռ 12  4 
+    int (*find_within[3])(const uint64_t* hashes, int count, const uint64_t* query, int threshold);
+};
+
+// ָںˣֻCPU֧ʱã
+const HashKernels& baseline_kernels();
+const HashKernels& sse42_kernels();
+const HashKernels& avx2_kernels();
+const HashKernels& avx512_kernels();
+
+/**
+ * @brief ǰCPUںˣ״εʱѡ
+ *
+ * û PV2I_KERNELSbaselinesse4.2avx2avx512ָϵ͵ָڶԱȺŲ⡣
+ *
+ * @return const HashKernels& ں
+ */
+const HashKernels& cpu_kernels();
+
+// ǰCPUֵ֧ȫںˣɵ͵
+std::vector<const HashKernels*> available_kernels();
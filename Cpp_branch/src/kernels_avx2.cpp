@@ -0,0 +1,11 @@
+//  AVX2/FMA ںˣѡ CMakeLists.txt
+#include "hash_kernels.hpp"
+
+#if !CV_AVX2 || !CV_FMA3 || !CV_POPCNT
+#error "kernels_avx2.cpp Ҫ AVX2/FMA ıѡ"
+#endif
+
+const HashKernels& avx2_kernels() {
+    static const HashKernels kernels = KERNEL_NAMESPACE::make_kernels("avx2");
+    return kernels;
+}
@@ -0,0 +1,11 @@
+//  AVX-512SKXָVPOPCNTDQںˣѡ CMakeLists.txt
+#include "hash_kernels.hpp"
+
+#if !CV_AVX512_SKX || !CV_AVX_512VPOPCNTDQ
+#error "kernels_avx512.cpp Ҫ AVX-512 ıѡ"
+#endif
+
+const HashKernels& avx512_kernels() {
+    static const HashKernels kernels = KERNEL_NAMESPACE::make_kernels("avx512");
+    return kernels;
+}
@@ -0,0 +1,11 @@
+//  SSE4.2/POPCNT ںˣѡ CMakeLists.txt
+#include "hash_kernels.hpp"
+
+#if !CV_SSE4_2 || !CV_POPCNT
+#error "kernels_sse42.cpp Ҫ SSE4.2/POPCNT ıѡ"
+#endif
+
+const HashKernels& sse42_kernels() {
+    static const HashKernels kernels = KERNEL_NAMESPACE::make_kernels("sse4.2");
+    return kernels;
+}
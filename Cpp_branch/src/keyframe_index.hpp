@@ -0,0 +1,196 @@
+#pragma once
+
+#include <opencv2/core/persistence.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/**
+ * @brief ƵĹؼ֡һ̽ɲƵԵСļС
+ *
+ * ؼ֡λɽʱƵģǴжȡģ probe_keyframesֻھʱλͶֶα߽硣
+ * ļС޸ʱΪƵ滻ԶʧЧ
+ */
+struct KeyframeIndex {
+    std::string file_size;      // ƵļС
+    std::string mtime;          // Ƶļ޸ʱ
+    int frame_count = 0;        // ʵʿɽ֡
+    std::vector<int> keyframes; // ؼ֡ţ
+
+    // ǷõĹؼ֡Ϣ
+    bool usable() const { return keyframes.size() >= 2; }
+
+    // ƽGOPȣ֡
+    double gop_length() const {
+        if (!usable()) return 0;
+        return double(keyframes.back() - keyframes.front()) / (keyframes.size() - 1);
+    }
+
+    /**
+     * @brief Ҳָ֡һؼ֡
+     *
+     * @param frame ֡
+     * @return int ؼ֡ţʱ -1
+     */
+    int keyframe_at_or_before(int frame) const {
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), frame);
+        return it == keyframes.begin() ? -1 : *(it - 1);
+    }
+};
+
+// ļ·
+inline std::string keyframe_index_path(const std::string& video_file) {
+    return video_file + ".pv2i.yml";
+}
+
+/**
+ * @brief ȡƵļĴС޸ʱ䣬Ϊļ
+ *
+ * @param video_file Ƶļ·
+ * @param file_size ļС
+ * @param mtime ޸ʱ
+ * @return bool Ƿȡɹ
+ */
+inline bool video_file_key(const std::string& video_file, std::string& file_size, std::string& mtime) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(video_file, ec);
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(video_file, ec);
+    if (ec) return false;
+    file_size = std::to_string(size);
+    mtime = std::to_string(time.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief ȡĹؼ֡ƥʱΪڡ
+ *
+ * @param video_file Ƶļ·
+ * @param index ȡ
+ * @return bool ǷȡЧ
+ */
+inline bool load_keyframe_index(const std::string& video_file, KeyframeIndex& index) {
+    std::string file_size, mtime;
+    if (!video_file_key(video_file, file_size, mtime)) return false;
+
+    std::string path = keyframe_index_path(video_file);
+    if (!std::filesystem::exists(path)) return false;
+    try {
+        cv::FileStorage fs(path, cv::FileStorage::READ);
+        if (!fs.isOpened()) return false;
+        if ((std::string)fs["file_size"] != file_size || (std::string)fs["mtime"] != mtime) return false;
+        index.file_size = file_size;
+        index.mtime = mtime;
+        fs["frame_count"] >> index.frame_count;
+        fs["keyframes"] >> index.keyframes;
+    } catch (const cv::Exception&) {
+        return false;
+    }
+    return index.frame_count > 0;
+}
+
+/**
+ * @brief ؼ֡дƵԵĻļ
+ *
+ * @param video_file Ƶļ·
+ * @param index ؼ֡
+ * @return bool Ƿдɹ
+ */
+inline bool save_keyframe_index(const std::string& video_file, const KeyframeIndex& index) {
+    try {
+        cv::FileStorage fs(keyframe_index_path(video_file), cv::FileStorage::WRITE);
+        if (!fs.isOpened()) return false;
+        fs << "file_size" << index.file_size;
+        fs << "mtime" << index.mtime;
+        fs << "frame_count" << index.frame_count;
+        fs << "keyframes" << index.keyframes;
+    } catch (const cv::Exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ̽˳Ƶƹؼ֡λá
+ *
+ * OpenCVṩ֡Ϣݽʱƣؼ֡Ҫ룬ʱԸڸԤ֡
+ * ڻ󲿷־ֹPPTƵΪԡƹؼ֡࣬Ϊ޷ɿʶֻ0֡
+ * ʱܻӰ죬޷ʶֻǱ̽ʱæ
+ *
+ * @param cap Ѵ򿪵Ƶ
+ * @param index ̽
+ * @param verbose Ƿ̽
+ * @return bool Ƿʶؼ֡Ϊ false ʱֻ֡͵0֡
+ */
+inline bool probe_keyframes(cv::VideoCapture& cap, KeyframeIndex& index, bool verbose = true) {
+    const int window = 31;        // οڣ֡
+    const double spike_ratio = 2.5; // ʱλıʱΪؼ֡
+    using clock = std::chrono::high_resolution_clock;
+
+    index.keyframes.clear();
+
+    std::vector<double> costs;
+    int total = int(cap.get(cv::CAP_PROP_FRAME_COUNT));
+    cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+    while (true) {
+        auto t0 = clock::now();
+        if (!cap.grab()) break;
+        std::chrono::duration<double> cost = clock::now() - t0;
+        costs.push_back(cost.count());
+        if (verbose && total > 0 && costs.size() % 1000 == 0) {
+            std::cout << "\rڽؼ֡" << costs.size() * 100 / total << " %" << std::flush;
+        }
+    }
+    if (verbose) std::cout << std::endl;
+    index.frame_count = int(costs.size());
+    if (costs.empty()) return false;
+
+    std::vector<double> ref;
+    for (int i = 0; i < index.frame_count; ++i) {
+        bool key = (i == 0);
+        if (i >= window) {
+            ref.assign(costs.begin() + i - window, costs.begin() + i);
+            std::nth_element(ref.begin(), ref.begin() + window / 2, ref.end());
+            key = costs[i] > spike_ratio * ref[window / 2];
+        }
+        if (key) index.keyframes.push_back(i);
+    }
+
+    if (index.keyframes.size() > size_t(index.frame_count / 8 + 1)) {
+        std::cerr << "޷ɿʶؼֻ֡ʹ֡дؼ֡" << std::endl;
+        index.keyframes.resize(1);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ȡĹؼ֡ʱ̽Ⲣд뻺档
+ *
+ * ޷ʶؼ֡ʱʹ̽õ֡д뻺棬´ʱ̽⡣
+ *
+ * @param video_file Ƶļ·
+ * @param cap Ѵ򿪵Ƶ̽λûı
+ * @param build 治ʱǷ̽
+ * @param index ȡ
+ * @param verbose Ƿ̽
+ * @return bool Ƿõ
+ */
+inline bool load_or_probe_keyframe_index(const std::string& video_file, cv::VideoCapture& cap, bool build, KeyframeIndex& index,
+                                         bool verbose = true) {
+    if (load_keyframe_index(video_file, index)) return true;
+    if (!build) return false;
+    if (!video_file_key(video_file, index.file_size, index.mtime)) return false;
+
+    bool identified = probe_keyframes(cap, index, verbose);
+    if (index.frame_count <= 0) return false;
+    if (identified && !save_keyframe_index(video_file, index)) {
+        std::cerr << "޷дؼ֡" << keyframe_index_path(video_file) << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Զдʽӳ䵽ڴļʱӶռ
+ *
+ * ʱֻӳȡҳ״ηʱϵͳ룬˴򿪺ܴļҲֻ賣ʱ䡣
+ * ļʱӳ䡢ӳļӳ䣬ӳַܸı䣬÷Ӧƫָ롣
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+/**
+ * @brief 򿪣ʱļӳ䣬ļ̴ʱʧܡ
+ *
+ * @param path ļ·
+ * @param error ʧԭ
+ * @return bool Ƿɹ
+ */
+    bool open(const std::string& path, std::string& error) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = GetLastError() == ERROR_SHARING_VIOLATION ? "ļʹã" + path : "޷ļ" + path;
+            return false;
+        }
+        LARGE_INTEGER length;
+        GetFileSizeEx(file, &length);
+        file_size = size_t(length.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            error = "޷ļ" + path;
+            return false;
+        }
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            close();
+            error = "ļʹã" + path;
+            return false;
+        }
+        struct stat info;
+        fstat(fd, &info);
+        file_size = size_t(info.st_size);
+#endif
+        if (file_size > 0 && !map()) {
+            close();
+            error = "޷ӳļ" + path;
+            return false;
+        }
+        return true;
+    }
+
+/**
+ * @brief ļӳ size ֽڲӳ䣬Ϊ0޷ӳʱԭӳ䡣
+ *
+ * @param size µļССڵǰС
+ * @return bool Ƿɹ
+ */
+    bool resize(size_t size) {
+        unmap();
+#ifdef _WIN32
+        LARGE_INTEGER length;
+        length.QuadPart = LONGLONG(size);
+        if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            map();
+            return false;
+        }
+#else
+        if (ftruncate(fd, off_t(size)) != 0) {
+            map();
+            return false;
+        }
+#endif
+        file_size = size;
+        return map();
+    }
+
+    // رļӳ޸ϵͳд
+    void close() {
+        unmap();
+#ifdef _WIN32
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        file_size = 0;
+    }
+
+    bool is_open() const {
+#ifdef _WIN32
+        return file != INVALID_HANDLE_VALUE;
+#else
+        return fd >= 0;
+#endif
+    }
+
+    uint8_t* data() const { return view; }
+    size_t size() const { return file_size; }
+
+private:
+    // ӳļ
+    bool map() {
+#ifdef _WIN32
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, DWORD(uint64_t(file_size) >> 32), DWORD(file_size), nullptr);
+        if (!mapping) return false;
+        view = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, file_size));
+#else
+        void* address = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        view = address == MAP_FAILED ? nullptr : static_cast<uint8_t*>(address);
+#endif
+        return view != nullptr;
+    }
+
+    // ӳ
+    void unmap() {
+#ifdef _WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        if (view) munmap(view, file_size);
+#endif
+        view = nullptr;
+    }
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE; // ļ
+    HANDLE mapping = nullptr;           // ӳ
+#else
+    int fd = -1;                        // ļ
+#endif
+    uint8_t* view = nullptr;            // ӳַ
+    size_t file_size = 0;               // ļСֽڣ
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "hash_list.hpp"
+#include "hash_value.hpp"
+
+/**
+ * @brief ϣmulti-index hashingӴңѹϣΪ m 16λӴÿӴһű
+ *
+ * 뾶 r = qm + a0 <= a < mʱɳԭѯľ벻 r ĹϣУǰ a+1 Ӵһ
+ * ѯӦӴľ벻 qӴһ q-1ֻڸвѯӴ
+ * ڸð뾶ڵļٶԺѡĺ롣64λϣΪ4Ρֵ4뾶3ʱÿűֻһ
+ *
+ * Ĵ洢㷨ֿÿűӴֱѰַ65536ͰͰԹϣӳ
+ * 洢ڴе MultiIndexӳ䵽ļ PersistentIndexṩ
+ * head(, )next(, )hash_distance(, ϣ)  size() -1 
+ */
+class SubstringTables {
+public:
+    // Ӵλ
+    static constexpr int substring_bits = 16;
+    // ÿűͰ
+    static constexpr int bucket_count = 1 << substring_bits;
+    // ÿű̽뾶ʱΪ˳Ƚϣ뾶3ʱÿű̽697
+    static constexpr int max_probe_radius = 3;
+
+    SubstringTables() = default;
+
+/**
+ * @brief 캯
+ *
+ * @param words Ƚϵ64λֵţйϣжΪ0
+ */
+    explicit SubstringTables(const std::vector<int>& words) {
+        for (int word : words) {
+            for (int shift = 64 - substring_bits; shift >= 0; shift -= substring_bits) substrings.push_back({word, shift});
+        }
+    }
+
+    // 
+    int count() const { return int(substrings.size()); }
+
+    // ϣڵ t űеļ
+    uint16_t key(const FrameHash& hash, int t) const { return uint16_t(hash.words[substrings[t].word] >> substrings[t].shift); }
+
+/**
+ * @brief ʺ벻 radius Ĺϣͬһϣܱűظʣ
+ *
+ * @param storage Ĵ洢
+ * @param hash ѯĹϣֵ
+ * @param radius 뾶
+ * @param visit ŵã true ʱֹͣ
+ */
+    template <typename Storage, typename Visit>
+    void search(const Storage& storage, const FrameHash& hash, int radius, Visit visit) const {
+        int m = count();
+        if (storage.size() == 0 || radius < 0 || m == 0) return;
+        int q = radius / m, a = radius % m;
+        if (q > max_probe_radius) {
+            for (int id = 0; id < int(storage.size()); ++id) {
+                if (storage.hash_distance(id, hash) <= radius && visit(id)) return;
+            }
+            return;
+        }
+        for (int t = 0; t < m; ++t) {
+            int table_radius = t <= a ? q : q - 1;
+            if (table_radius < 0) break;
+            auto verify = [&](uint16_t key) {
+                // еϸݼԽ¼ٵݼļ𻵣ʱֹͣԽѭ
+                for (int id = storage.head(t, key), limit = int(storage.size()); id >= 0 && id < limit;
+                     limit = id, id = storage.next(t, id)) {
+                    if (storage.hash_distance(id, hash) <= radius && visit(id)) return true;
+                }
+                return false;
+            };
+            if (probe(key(hash, t), table_radius, 0, verify)) return;
+        }
+    }
+
+private:
+    // һӴλ
+    struct Substring {
+        int word;  // ڵ64λ
+        int shift; // λ
+    };
+
+    // η key ľ벻 radius ļֻת first_bit ֮λÿֻһΣvisit  true ʱֹͣ
+    template <typename Visit>
+    static bool probe(uint16_t key, int radius, int first_bit, Visit& visit) {
+        if (visit(key)) return true;
+        if (radius == 0) return false;
+        for (int bit = first_bit; bit < substring_bits; ++bit) {
+            if (probe(uint16_t(key ^ (1 << bit)), radius - 1, bit + 1, visit)) return true;
+        }
+        return false;
+    }
+
+    std::vector<Substring> substrings; // ӴλãÿӴһű
+};
+
+/**
+ * @brief ڴеĶϣϣ뾶ѯ㷨 SubstringTables
+ *
+ * Ͱڵ±ӣʱС󣻹ϣ HashList УֻŵȽϵһ֡
+ */
+class MultiIndex {
+public:
+/**
+ * @brief 캯
+ *
+ * @param words Ƚϵ64λֵţйϣжΪ0
+ */
+    explicit MultiIndex(const std::vector<int>& words)
+        : tables(words), distance(HashDistance::hamming(words.empty() ? 1 : *std::max_element(words.begin(), words.end()) + 1)),
+          hashes(distance.words) {
+        heads.assign(tables.count(), std::vector<int>(SubstringTables::bucket_count, -1));
+        links.resize(tables.count());
+    }
+
+/**
+ * @brief һϣֵ
+ *
+ * @param hash ϣֵ
+ * @return int 
+ */
+    int insert(const FrameHash& hash) {
+        int id = int(hashes.size());
+        hashes.push_back(hash);
+        for (int t = 0; t < tables.count(); ++t) {
+            int& first = heads[t][tables.key(hash, t)];
+            links[t].push_back(first);
+            first = id;
+        }
+        return id;
+    }
+
+/**
+ * @brief 뾶ѯ벻 radius йϣֵ
+ *
+ * @param hash ѯĹϣֵ
+ * @param radius 뾶
+ * @param result ţ򡢲ظ׷ӵĩβ
+ */
+    void query(const FrameHash& hash, int radius, std::vector<int>& result) const {
+        size_t first = result.size();
+        tables.search(*this, hash, radius, [&](int id) {
+            result.push_back(id);
+            return false;
+        });
+        std::sort(result.begin() + first, result.end());
+        result.erase(std::unique(result.begin() + first, result.end()), result.end());
+    }
+
+/**
+ * @brief һ hash ĺС threshold Ĺϣֵҵء
+ *
+ * @param hash ѯĹϣֵ
+ * @param threshold ޣ
+ * @return int ţûʱ -1
+ */
+    int find_within(const FrameHash& hash, int threshold) const {
+        int found = -1;
+        tables.search(*this, hash, threshold - 1, [&](int id) {
+            found = id;
+            return true;
+        });
+        return found;
+    }
+
+    size_t size() const { return hashes.size(); }
+    bool empty() const { return hashes.empty(); }
+    FrameHash operator[](size_t id) const { return hashes[id]; }
+
+    // Ԥռ
+    void reserve(size_t count) {
+        hashes.reserve(count);
+        for (auto& table_links : links) table_links.reserve(count);
+    }
+
+private:
+    friend class SubstringTables;
+
+    //  SubstringTables::search ʵı
+    int head(int t, uint16_t key) const { return heads[t][key]; }
+    int next(int t, int id) const { return links[t][id]; }
+    int hash_distance(int id, const FrameHash& hash) const { return distance(hashes.data(id), hash.words.data()); }
+
+    SubstringTables tables;              // Ӵ
+    HashDistance distance;               // 룬ȽϵȽϵһ
+    std::vector<std::vector<int>> heads; // ĵһϣûʱΪ -1
+    std::vector<std::vector<int>> links; // ͬһһϣûʱΪ -1
+    HashList hashes;                     // ϣֵ±꼴
+};
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "hash_value.hpp"
+#include "mapped_file.hpp"
+#include "multi_index.hpp"
+
+// йϣĸʽеʱ뱾еĲͬϣ޷Ƚ
+struct IndexFormat {
+    uint32_t hash_kind = 0; // ֪ϣ㷨HashKind
+    uint32_t hash_bits = 0; // ϣλ
+    uint32_t tile_rows = 0; // ָϣָʱΪ0
+    uint32_t tile_cols = 0; // ָϣ
+    uint32_t colour = 0;    // Ƿ񸽼ɫǩ
+
+    bool operator==(const IndexFormat& other) const {
+        return hash_kind == other.hash_kind && hash_bits == other.hash_bits && tile_rows == other.tile_rows
+            && tile_cols == other.tile_cols && colour == other.colour;
+    }
+    bool operator!=(const IndexFormat& other) const { return !(*this == other); }
+};
+
+// һѱͼƬԴ
+struct IndexEntry {
+    std::string source;      // ԴƵ
+    double timestamp = 0;    // ʾʱms
+    std::string output_path; // ͼƬ·
+};
+
+/**
+ * @brief ڴϵֻ׷ӹϣйãѱĻ治
+ *
+ * ļӳ䵽ڴ棬ṹ MultiIndex ͬȫļڵƫʾļͷһҳ֮ǸӴ
+ * ͷ65536ţ֮Ƕ¼ϣʱֵλԼָ룩
+ * ¼еĹϣֻűθʽʵռõ֣ HashDistance64λϣļ¼Ϊ48ֽڣ256λΪ80ֽڡ
+ * ʱֻļͷȡҲؽκνṹ¼򿪺ֻڲѯʱõļҳ
+ * ¼дʱļӱеԭزԴƵ·Ȳ׷ͬ .txt ļУ
+ * ҲֱӲ鿴ָϣܰӴ֣ѯʱ˳Ƚϡ
+ */
+class PersistentIndex {
+public:
+    PersistentIndex() = default;
+    PersistentIndex(const PersistentIndex&) = delete;
+    PersistentIndex& operator=(const PersistentIndex&) = delete;
+    ~PersistentIndex() { close(); }
+
+/**
+ * @brief ļʱ
+ *
+ * @param path ļ·
+ * @param format ϣʽͬ
+ * @param distance ϣ룬¼д words 
+ * @param words ϣռõ64λֵţڽָ벻
+ * @param error ʧԭ
+ * @return bool Ƿɹ
+ */
+    bool open(const std::string& path, const IndexFormat& format, HashDistance distance, const std::vector<int>& words,
+              std::string& error) {
+        close();
+        this->distance = distance;
+        tables = distance.tiled ? SubstringTables() : SubstringTables(words);
+        if (!file.open(path, error)) return false;
+        uint32_t table_count = uint32_t(tables.count());
+        hash_size = size_t(distance.words) * sizeof(uint64_t);
+        uint32_t record_size = uint32_t((hash_size + offsetof(Record, links) + table_count * sizeof(int32_t) + 15) / 16 * 16);
+        records_offset = header_size + size_t(table_count) * SubstringTables::bucket_count * sizeof(int32_t);
+
+        if (file.size() == 0) {
+            // ½ͷȫΪ -1
+            if (!file.resize(records_offset + initial_capacity * record_size)) {
+                error = "޷ļ" + path;
+                return false;
+            }
+            Header& created = header();
+            std::memcpy(created.magic, magic, sizeof(created.magic));
+            created.version = version;
+            created.format = format;
+            created.table_count = table_count;
+            created.record_size = record_size;
+            created.capacity = initial_capacity;
+            std::memset(file.data() + header_size, 0xFF, records_offset - header_size);
+        } else {
+            const Header& existing = header();
+            if (file.size() < header_size || std::memcmp(existing.magic, magic, sizeof(existing.magic)) != 0) {
+                error = "ЧĹϣļ" + path;
+                return false;
+            }
+            if (existing.version != version) {
+                error = "ϣļɲͬİ汾Ҫ½" + path;
+                return false;
+            }
+            if (existing.format != format) {
+                error = "йϣ㷨λָɫǩ뱾βͬ" + path;
+                return false;
+            }
+            if (existing.table_count != table_count || existing.record_size != record_size
+                || existing.count > existing.capacity || file.size() < records_offset + existing.capacity * record_size
+                || existing.appending > existing.count + 1 || existing.appending > existing.capacity) {
+                error = "ļ𻵣" + path;
+                return false;
+            }
+            if (existing.appending != 0) recover_append();
+        }
+
+        text = std::fopen(text_path(path).c_str(), "a+b");
+        if (!text) {
+            error = "޷·¼" + text_path(path);
+            return false;
+        }
+        return true;
+    }
+
+    // ر
+    void close() {
+        file.close();
+        if (text) std::fclose(text);
+        text = nullptr;
+    }
+
+    bool is_open() const { return file.is_open() && text; }
+
+    // ¼
+    size_t size() const { return file.is_open() ? size_t(header().count) : 0; }
+
+/**
+ * @brief һ hash ľС threshold ļ¼ҵء
+ *
+ * @param hash ѯĹϣֵ
+ * @param threshold ޣ
+ * @return int ¼ţûʱ -1
+ */
+    int find_within(const FrameHash& hash, int threshold) const {
+        if (!is_open()) return -1;
+        int found = -1;
+        if (tables.count() > 0) {
+            tables.search(*this, hash, threshold - 1, [&](int id) {
+                found = id;
+                return true;
+            });
+            return found;
+        }
+        for (int id = 0; id < int(size()); ++id) {
+            if (hash_distance(id, hash) < threshold) return id;
+        }
+        return -1;
+    }
+
+/**
+ * @brief ׷һ¼д·¼дϣ¼Ӽ¼;˳ʱ²ļ¼
+ *
+ * ޸ͷǰļͷб׷ӵļ¼ͷָ¼δʱ˳´δʱЩͷ
+ *
+ * @param hash ϣֵ
+ * @param source ԴƵ
+ * @param timestamp ʾʱms
+ * @param output_path ͼƬ·
+ * @return bool Ƿɹ
+ */
+    bool append(const FrameHash& hash, const std::string& source, double timestamp, const std::string& output_path) {
+        if (!is_open()) return false;
+        if (header().count == header().capacity && !grow()) return false;
+
+        int64_t text_offset = seek_text(0, SEEK_END) ? tell_text() : -1;
+        if (text_offset < 0) return false;
+        std::string line = source + "\t" + std::to_string(timestamp) + "\t" + output_path;
+        if (std::fprintf(text, "%s\n", line.c_str()) < 0 || std::fflush(text) != 0) return false;
+
+        int id = int(header().count);
+        std::memcpy(record_hash(id), hash.words.data(), hash_size);
+        Record& added = record(id);
+        added.timestamp = timestamp;
+        added.text_offset = uint64_t(text_offset);
+        added.text_size = uint32_t(line.size());
+        // ļӳڴУ˳ʱдݶᱣֹֻд˳
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header().appending = uint64_t(id) + 1;
+        for (int t = 0; t < tables.count(); ++t) {
+            int32_t& first = heads(t)[tables.key(hash, t)];
+            added.links[t] = first;
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            first = id;
+        }
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header().count++;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header().appending = 0;
+        return true;
+    }
+
+/**
+ * @brief ȡһ¼Դ
+ *
+ * @param id ¼
+ * @return IndexEntry Դ·¼޷ȡʱԴƵ·Ϊ
+ */
+    IndexEntry entry(int id) const {
+        IndexEntry result;
+        const Record& found = record(id);
+        result.timestamp = found.timestamp;
+        std::string line(found.text_size, '\0');
+        if (!seek_text(int64_t(found.text_offset), SEEK_SET)
+            || std::fread(&line[0], 1, line.size(), text) != line.size()) {
+            return result;
+        }
+        size_t first = line.find('\t'), last = line.rfind('\t');
+        if (first == std::string::npos || last == first) return result;
+        result.source = line.substr(0, first);
+        result.output_path = line.substr(last + 1);
+        return result;
+    }
+
+    FrameHash operator[](size_t id) const {
+        FrameHash hash;
+        std::memcpy(hash.words.data(), record_hash(int(id)), hash_size);
+        return hash;
+    }
+
+private:
+    friend class SubstringTables;
+
+    static constexpr char magic[8] = {'P', 'V', '2', 'I', 'H', 'I', 'D', 'X'};
+    static constexpr uint32_t version = 2;           // ļʽ汾2 ¼еĹϣֻʵռõ
+    static constexpr size_t header_size = 4096;      // ļͷռһҳͷͼ¼ҳ
+    static constexpr uint64_t initial_capacity = 1024; // ½ļ¼
+
+    // ļͷ
+    struct Header {
+        char magic[8];        // "PV2IHIDX"
+        uint32_t version;     // ļʽ汾
+        IndexFormat format;   // ϣʽ
+        uint32_t table_count; // Ӵ
+        uint32_t record_size; // ÿ¼ָֽ룩
+        uint64_t count;       // ύļ¼
+        uint64_t capacity;    // ļпɵļ¼
+        uint64_t appending;   // ޸ļ¼ż1ûʱΪ0ļд˴Ϊ0
+    };
+
+    // һ¼ǰǹϣֵhash_size ֽڣ֮Ӹͬһһ¼ţûʱΪ -1
+    struct Record {
+        double timestamp;     // ʾʱms
+        uint64_t text_offset; // ·¼ .txt ļеλ
+        uint32_t text_size;   // ·¼ĳȣз
+        int32_t links[1];     // ָ루ʵʳΪ
+    };
+
+    // ·¼ļ
+    static std::string text_path(const std::string& path) { return path + ".txt"; }
+
+    // ·¼ļĶλlong  Windows ֻ32λ 2GB ļ64λĽӿ
+    bool seek_text(int64_t offset, int origin) const {
+#ifdef _WIN32
+        return _fseeki64(text, offset, origin) == 0;
+#else
+        return fseeko(text, off_t(offset), origin) == 0;
+#endif
+    }
+    int64_t tell_text() const {
+#ifdef _WIN32
+        return _ftelli64(text);
+#else
+        return int64_t(ftello(text));
+#endif
+    }
+
+    Header& header() const { return *reinterpret_cast<Header*>(file.data()); }
+    int32_t* heads(int t) const {
+        return reinterpret_cast<int32_t*>(file.data() + header_size) + size_t(t) * SubstringTables::bucket_count;
+    }
+    uint64_t* record_hash(int id) const {
+        return reinterpret_cast<uint64_t*>(file.data() + records_offset + size_t(id) * header().record_size);
+    }
+    Record& record(int id) const { return *reinterpret_cast<Record*>(reinterpret_cast<char*>(record_hash(id)) + hash_size); }
+
+    //  SubstringTables::search ʵı
+    int head(int t, uint16_t key) const { return heads(t)[key]; }
+    int next(int t, int id) const { return record(id).links[t]; }
+    int hash_distance(int id, const FrameHash& hash) const { return distance(record_hash(id), hash.words.data()); }
+
+    // ׷;˳ʱָδύ¼ͷü¼ָ޸ͷ֮ǰд
+    void recover_append() {
+        int id = int(header().appending - 1);
+        if (uint64_t(id) == header().count) {
+            FrameHash pending_hash = (*this)[size_t(id)];
+            const Record& pending = record(id);
+            for (int t = 0; t < tables.count(); ++t) {
+                int32_t& first = heads(t)[tables.key(pending_hash, t)];
+                if (first == id) first = pending.links[t];
+            }
+        }
+        header().appending = 0;
+    }
+
+    // ӱ
+    bool grow() {
+        uint64_t capacity = header().capacity * 2;
+        size_t record_size = header().record_size;
+        if (!file.resize(records_offset + capacity * record_size)) return false;
+        header().capacity = capacity;
+        return true;
+    }
+
+    MappedFile file;                          // ӳļ
+    std::FILE* text = nullptr;                // ·¼ļ
+    size_t records_offset = 0;                // һ¼ļеƫ
+    size_t hash_size = 0;                     // ÿ¼йϣֵֽ
+    SubstringTables tables;                   // Ӵ֣ʱΪ
+    HashDistance distance;                    // ϣ
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hash_value.hpp"
+#include "kernels.hpp"
+#include "pixel_layout.hpp"
+
+// ɸԪUVƽֵɫȣ2max(|U-128|, |V-128|)BGRСͬһUVȺ޹
+inline void uv_chroma(const float* u, const float* v, int stride, float* chroma) {
+    for (int i = 0; i < thumbnail_size * thumbnail_size; ++i) {
+        chroma[i] = 2 * std::max(std::abs(u[i * stride] - 128), std::abs(v[i * stride] - 128));
+    }
+}
+
+/**
+ * @brief ɽֱɹϣͼBGRҶȺ͸YUVŲֻȡһΣɫת
+ *
+ * ҪɫͼʱBGRͬһζȡеõͨƽֵ4:2:0 ȡֻķ֮һСɫƽ棻
+ * 4:2:2 Ϊأ4ֽڣһȡͬһζȡеõUVҶɫΪ0
+ *
+ * @param raw 
+ * @param layout Ų
+ * @param thumbnail ÷е 3232 float ȣ
+ * @param roi ֻʹûеһƽؼƣΪʱʹ
+ * @param chroma ΪգΪʱ 3232 ɫͼԪƽɫıͳ̶ȣ0255
+ */
+inline void make_thumbnail(const cv::Mat& raw, PixelLayout layout, float* thumbnail, const cv::Rect& roi = cv::Rect(),
+                           float* chroma = nullptr) {
+    static const float bgr_weights[3] = {0.114f, 0.587f, 0.299f}; //  COLOR_BGR2GRAY ͬ
+    static const float first[2] = {1, 0};
+    static const float second[2] = {0, 1};
+    static const float packed_first[4] = {0.5f, 0, 0.5f, 0}; // һʱȣYUYV
+    static const float packed_second[4] = {0, 0.5f, 0, 0.5f}; // һʱȣUYVY
+    CV_Assert(raw.depth() == CV_8U && raw.channels() <= 3);
+
+    int width = raw.cols, height = raw.rows, channels = raw.channels();
+    const float* weights = channels == 3 ? bgr_weights : first;
+    bool planar = false; // ǷΪ4:2:0ɫƽ֮
+    switch (layout) {
+    case PixelLayout::I420:
+    case PixelLayout::YV12:
+    case PixelLayout::NV12:
+    case PixelLayout::NV21:
+        height = raw.rows * 2 / 3; // ֻȡYƽ
+        planar = true;
+        break;
+    case PixelLayout::UYVY:
+        weights = second;
+        break;
+    default:
+        break;
+    }
+
+    cv::Rect region = roi & cv::Rect(0, 0, width, height);
+    if (region.empty()) region = cv::Rect(0, 0, width, height); // ȲüСزȡ
+    const uint8_t* data = raw.data + size_t(region.y) * raw.step + size_t(region.x) * channels;
+    const HashKernels& kernels = cpu_kernels();
+    if (!chroma) {
+        kernels.area_thumbnail(data, raw.step, region.width, region.height, channels, weights, thumbnail, nullptr);
+        return;
+    }
+
+    float means[thumbnail_size * thumbnail_size * 4];
+    if (layout == PixelLayout::BGR) {
+        kernels.area_thumbnail(data, raw.step, region.width, region.height, 3, bgr_weights, thumbnail, means);
+        for (int i = 0; i < thumbnail_size * thumbnail_size; ++i) {
+            const float* bgr = means + i * 3;
+            chroma[i] = std::max({bgr[0], bgr[1], bgr[2]}) - std::min({bgr[0], bgr[1], bgr[2]});
+        }
+    } else if (layout == PixelLayout::YUYV || layout == PixelLayout::UYVY) {
+        // һΪ Y U Y V  U Y V Y뵽ż
+        int x = region.x & ~1, pairs = std::max(1, (region.x + region.width - x) / 2);
+        data = raw.data + size_t(region.y) * raw.step + size_t(x) * 2;
+        bool yuyv = layout == PixelLayout::YUYV;
+        kernels.area_thumbnail(data, raw.step, pairs, region.height, 4, yuyv ? packed_first : packed_second, thumbnail, means);
+        uv_chroma(means + (yuyv ? 1 : 0), means + (yuyv ? 3 : 2), 4, chroma);
+    } else if (planar) {
+        kernels.area_thumbnail(data, raw.step, region.width, region.height, 1, first, thumbnail, nullptr);
+        // ɫƽĿ߶Ϊƽһ룬򰴱
+        cv::Rect half(region.x / 2, region.y / 2, std::max(1, region.width / 2), std::max(1, region.height / 2));
+        const uint8_t* planes = raw.ptr<uint8_t>(height);
+        if (layout == PixelLayout::NV12 || layout == PixelLayout::NV21) {
+            // UVһζȡȨҪ
+            float unused[thumbnail_size * thumbnail_size];
+            data = planes + size_t(half.y) * raw.step + size_t(half.x) * 2;
+            kernels.area_thumbnail(data, raw.step, half.width, half.height, 2, first, unused, means);
+            uv_chroma(means, means + 1, 2, chroma);
+        } else {
+            // UVΪһƽ棬оΪȵһ
+            CV_Assert(raw.isContinuous());
+            size_t plane_step = raw.cols / 2, plane_size = plane_step * (height / 2);
+            float* u = means;
+            float* v = means + thumbnail_size * thumbnail_size;
+            data = planes + half.y * plane_step + half.x;
+            kernels.area_thumbnail(data, plane_step, half.width, half.height, 1, first, u, nullptr);
+            kernels.area_thumbnail(data + plane_size, plane_step, half.width, half.height, 1, first, v, nullptr);
+            uv_chroma(u, v, 1, chroma);
+        }
+    } else {
+        kernels.area_thumbnail(data, raw.step, region.width, region.height, channels, weights, thumbnail, nullptr);
+        std::fill(chroma, chroma + thumbnail_size * thumbnail_size, 0.0f); // Ҷûɫ
+    }
+}
+
+// ͼϣĺͳһչΪ256λ
+using HashFunction = FrameHash (*)(const float* thumbnail);
+
+// ɰCPUѡں˼ϣ
+template <HashKind Kind, int Bits>
+inline FrameHash compute_frame_hash(const float* thumbnail) {
+    FrameHash hash;
+    cpu_kernels().hash[int(Kind)][hash_width_index(Bits)](thumbnail, hash.words.data());
+    return hash;
+}
+
+// ʱѡλ
+template <HashKind Kind>
+inline HashFunction hash_function_of_width(int bits) {
+    switch (bits) {
+    case 128: return compute_frame_hash<Kind, 128>;
+    case 256: return compute_frame_hash<Kind, 256>;
+    default: return compute_frame_hash<Kind, 64>;
+    }
+}
+
+/**
+ * @brief ʱѡĹϣ㺯
+ *
+ * @param kind 㷨
+ * @param bits λ64128  256ֵ64
+ * @return HashFunction 㺯
+ */
+inline HashFunction hash_function(HashKind kind, int bits = 64) {
+    switch (kind) {
+    case HashKind::AHash: return hash_function_of_width<HashKind::AHash>(bits);
+    case HashKind::DHash: return hash_function_of_width<HashKind::DHash>(bits);
+    case HashKind::BlockMean: return hash_function_of_width<HashKind::BlockMean>(bits);
+    case HashKind::Haar: return hash_function_of_width<HashKind::Haar>(bits);
+    default: return hash_function_of_width<HashKind::PHash>(bits);
+    }
+}
+
+// 㷨ƣ parse_hash_kind Ӧ
+inline const char* hash_kind_name(HashKind kind) {
+    switch (kind) {
+    case HashKind::AHash: return "ahash";
+    case HashKind::DHash: return "dhash";
+    case HashKind::BlockMean: return "blockmean";
+    case HashKind::Haar: return "haar";
+    default: return "phash";
+    }
+}
+
+/**
+ * @brief ƽϣ㷨
+ *
+ * @param name ahashdhashphashblockmean  haar
+ * @param kind 
+ * @return bool ǷЧ
+ */
+inline bool parse_hash_kind(const std::string& name, HashKind& kind) {
+    for (HashKind k : {HashKind::AHash, HashKind::DHash, HashKind::PHash, HashKind::BlockMean, HashKind::Haar}) {
+        if (name == hash_kind_name(k)) {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief ͼṹ飬SoAͬһλõĸͼֵţ
+ * ϣʱһĸֱͨӦͬͼDCTֻȡһΡ
+ */
+class ThumbnailBatch {
+public:
+/**
+ * @brief 캯
+ *
+ * @param capacity ɵͼ
+ */
+    explicit ThumbnailBatch(int capacity)
+        : capacity(std::max(1, capacity)), stride((this->capacity + max_lanes - 1) / max_lanes * max_lanes),
+          data(size_t(thumbnail_size) * thumbnail_size * stride, 0.0f) {}
+
+    int size() const { return count; }
+    bool full() const { return count >= capacity; }
+    void clear() { count = 0; }
+
+    // ɽͼ룬
+    int add(const cv::Mat& raw, PixelLayout layout) {
+        float thumbnail[thumbnail_size * thumbnail_size];
+        make_thumbnail(raw, layout, thumbnail);
+        return add(thumbnail);
+    }
+
+    // һеͼ
+    int add(const float* thumbnail) {
+        CV_Assert(count < capacity);
+        for (int p = 0; p < thumbnail_size * thumbnail_size; ++p) data[size_t(p) * stride + count] = thumbnail[p];
+        return count++;
+    }
+
+    //  p λõĸͼֵ
+    const float* pixel(int p) const { return data.data() + size_t(p) * stride; }
+
+    // λõļࣨfloat 
+    int pixel_stride() const { return stride; }
+
+    // ȡ i ͼȣ
+    void get(int i, float* thumbnail) const {
+        for (int p = 0; p < thumbnail_size * thumbnail_size; ++p) thumbnail[p] = data[size_t(p) * stride + i];
+    }
+
+private:
+    static constexpr int max_lanes = 16; // AVX-512ɵ float 
+    const int capacity;                  // ɵͼ
+    const int stride;                    // ÿλõͨ뵽ȣ
+    std::vector<float> data;             // ͼݣdata[p * stride + i] Ϊ i ŵĵ p 
+    int count = 0;                       // ǰͼ
+};
+
+/**
+ * @brief ϣpHashʹʵ֣㷨ֻٵļ㣬ż㡣
+ *
+ * @param batch ͼ
+ * @param kind 㷨
+ * @param bits λ64128  256
+ * @param hashes batch.size() ϣֵ
+ */
+inline void hash_batch(const ThumbnailBatch& batch, HashKind kind, int bits, FrameHash* hashes) {
+    if (kind == HashKind::PHash) {
+        cpu_kernels().phash_batch[hash_width_index(bits)](batch.pixel(0), batch.pixel_stride(), batch.size(), hashes[0].words.data());
+        return;
+    }
+    HashFunction hasher = hash_function(kind, bits);
+    float thumbnail[thumbnail_size * thumbnail_size];
+    for (int i = 0; i < batch.size(); ++i) {
+        batch.get(i, thumbnail);
+        hashes[i] = hasher(thumbnail);
+    }
+}
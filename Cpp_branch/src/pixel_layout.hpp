@@ -0,0 +1,81 @@
+#pragma once
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+// õ֡Ų
+enum class PixelLayout {
+    BGR,   // 3ͨBGR
+    Gray,  // ͨ
+    I420,  // ƽYUV 4:2:0YUV
+    YV12,  // ƽYUV 4:2:0YVU
+    NV12,  // ƽYUV 4:2:0YUV
+    NV21,  // ƽYUV 4:2:0YVU
+    YUYV,  // YUV 4:2:2
+    UYVY,  // YUV 4:2:2Uǰ
+};
+
+/**
+ * @brief ݽ״ͺ˱ظʽжŲ
+ *
+ * @param raw 
+ * @param height Ƶ߶
+ * @param fourcc ˱ظʽCAP_PROP_CODEC_PIXEL_FORMATδ֪ʱΪ0
+ * @return PixelLayout Ų
+ */
+inline PixelLayout detect_pixel_layout(const cv::Mat& raw, int height, int fourcc) {
+    auto is = [fourcc](const char* code) { return fourcc == cv::VideoWriter::fourcc(code[0], code[1], code[2], code[3]); };
+    if (raw.channels() == 3) return PixelLayout::BGR;
+    if (raw.channels() == 2) return is("UYVY") ? PixelLayout::UYVY : PixelLayout::YUYV;
+    if (raw.rows == height) return PixelLayout::Gray;
+    if (is("NV12")) return PixelLayout::NV12;
+    if (is("NV21")) return PixelLayout::NV21;
+    if (is("YV12")) return PixelLayout::YV12;
+    return PixelLayout::I420;
+}
+
+/**
+ * @brief ȡƽ档ƽͰƽʽֱӷYƽͼơ
+ *
+ * @param raw 
+ * @param layout Ų
+ * @param luma ƽ棨BGRʱΪԭͼɹϣת
+ */
+inline void luma_view(const cv::Mat& raw, PixelLayout layout, cv::Mat& luma) {
+    switch (layout) {
+    case PixelLayout::I420:
+    case PixelLayout::YV12:
+    case PixelLayout::NV12:
+    case PixelLayout::NV21:
+        luma = raw.rowRange(0, raw.rows * 2 / 3);
+        break;
+    case PixelLayout::YUYV:
+        cv::extractChannel(raw, luma, 0);
+        break;
+    case PixelLayout::UYVY:
+        cv::extractChannel(raw, luma, 1);
+        break;
+    default:
+        luma = raw;
+        break;
+    }
+}
+
+/**
+ * @brief תΪBGRֻҪ֡á
+ *
+ * @param raw 
+ * @param layout Ų
+ * @param bgr תGrayBGRʱֱԭͼ
+ */
+inline void to_bgr(const cv::Mat& raw, PixelLayout layout, cv::Mat& bgr) {
+    switch (layout) {
+    case PixelLayout::I420: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_I420); break;
+    case PixelLayout::YV12: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_YV12); break;
+    case PixelLayout::NV12: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_NV12); break;
+    case PixelLayout::NV21: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_NV21); break;
+    case PixelLayout::YUYV: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_YUYV); break;
+    case PixelLayout::UYVY: cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_UYVY); break;
+    default: bgr = raw; break;
+    }
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "frame_sampler.hpp"
+#include "pixel_layout.hpp"
+
+/**
+ * @brief ӱ׼ܵȡδѹ֡rawvideo  Y4M
+ *
+ * ֱ֡Ӷһ鸴õĻκתYUV 4:2:0  OpenCV Լų (h*3/2)w ĵͨͼ
+ * YUVʱ״ͬ˿ֱӽ luma_view  to_bgr
+ */
+class RawFrameReader {
+public:
+    RawFrameReader() = default;
+    RawFrameReader(const RawFrameReader&) = delete;
+    RawFrameReader& operator=(const RawFrameReader&) = delete;
+    ~RawFrameReader() {
+        if (file && file != stdin) std::fclose(file);
+    }
+
+/**
+ * @brief 롣
+ *
+ * @param path ·"-" ʾ׼
+ * @param raw_format rawvideo ĸʽ "x:ظʽ[:֡]"ظʽΪ graybgr24yuv420pnv12nv21
+ *                   Ϊʱ Y4M 
+ * @param error ʧԭ
+ * @return bool Ƿɹ
+ */
+    bool open(const std::string& path, const std::string& raw_format, std::string& error) {
+        if (path == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY); // Windows±׼ĬΪıģʽдֽ
+#endif
+            file = stdin;
+        } else {
+            file = std::fopen(path.c_str(), "rb");
+        }
+        if (!file) {
+            error = "޷룺" + path;
+            return false;
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+        y4m = raw_format.empty();
+        if (y4m ? !read_y4m_header(error) : !parse_raw_format(raw_format, error)) return false;
+
+        switch (pixel_layout) {
+        case PixelLayout::BGR: buffer.create(height, width, CV_8UC3); break;
+        case PixelLayout::Gray: buffer.create(height, width, CV_8UC1); break;
+        default: buffer.create(height * 3 / 2, width, CV_8UC1); break;
+        }
+        frame_bytes = buffer.total() * buffer.elemSize();
+        return true;
+    }
+
+/**
+ * @brief ȡһ֡frame ڲһζȡʱᱻǡ
+ *
+ * @param frame ȡ
+ * @return bool ʱ false
+ */
+    bool read(cv::Mat& frame) {
+        if (!read_frame()) return false;
+        frame = buffer;
+        return true;
+    }
+
+    // ȡһ֡ܵ޷λ
+    bool skip() { return read_frame(); }
+
+    double fps() const { return frame_rate; }
+    PixelLayout layout() const { return pixel_layout; }
+    cv::Size frame_size() const { return cv::Size(width, height); }
+
+private:
+    // ȡһ֡
+    bool read_frame() {
+        if (y4m) {
+            // ÿ֡ǰһ "FRAME[ ]\n"
+            std::string line;
+            if (!read_line(line) || line.compare(0, 5, "FRAME") != 0) return false;
+        }
+        return std::fread(buffer.data, 1, frame_bytes, file) == frame_bytes;
+    }
+
+    // ȡһУз
+    bool read_line(std::string& line) {
+        line.clear();
+        for (int c; (c = std::fgetc(file)) != EOF;) {
+            if (c == '\n') return true;
+            if (line.size() > 4096) return false;
+            line.push_back(char(c));
+        }
+        return false;
+    }
+
+    //  "x:ظʽ[:֡]"
+    bool parse_raw_format(const std::string& spec, std::string& error) {
+        std::istringstream in(spec);
+        char x = 0, colon = 0;
+        std::string pix_fmt;
+        if (!(in >> width >> x >> height >> colon) || x != 'x' || colon != ':' || !std::getline(in, pix_fmt, ':')) {
+            error = "޷rawvideoʽ" + spec;
+            return false;
+        }
+        double rate = 0;
+        if (in >> rate && rate > 0) frame_rate = rate;
+        return set_pixel_format(pix_fmt, error);
+    }
+
+    // Y4Mļͷ "YUV4MPEG2 W1920 H1080 F30000:1001 Ip A1:1 C420jpeg"
+    bool read_y4m_header(std::string& error) {
+        std::string line;
+        if (!read_line(line) || line.compare(0, 9, "YUV4MPEG2") != 0) {
+            error = "벻Y4Mʽrawvideoָ raw_format";
+            return false;
+        }
+        std::istringstream in(line.substr(9));
+        std::string token, colorspace = "420";
+        while (in >> token) {
+            switch (token[0]) {
+            case 'W': width = std::atoi(token.c_str() + 1); break;
+            case 'H': height = std::atoi(token.c_str() + 1); break;
+            case 'C': colorspace = token.substr(1); break;
+            case 'F': {
+                double num = 0, den = 0;
+                if (std::sscanf(token.c_str() + 1, "%lf:%lf", &num, &den) == 2 && num > 0 && den > 0) frame_rate = num / den;
+                break;
+            }
+            default: break; // Сؿ߱ȵϣ޹
+            }
+        }
+        // ֻ8λ4:2:0ɫλãͻҶȣ420p10mono16 ȸλʽÿռ2ֽڣܰ8λȡ
+        if (colorspace == "420" || colorspace == "420jpeg" || colorspace == "420paldv" || colorspace == "420mpeg2") {
+            return set_pixel_format("yuv420p", error);
+        }
+        if (colorspace == "mono") return set_pixel_format("gray", error);
+        error = "ֵ֧Y4MɫʸʽC" + colorspace + "ֻ֧8λ420mono ffmpeg -pix_fmt yuv420p ת";
+        return false;
+    }
+
+    // ظʽߴ
+    bool set_pixel_format(const std::string& pix_fmt, std::string& error) {
+        if (pix_fmt == "gray") pixel_layout = PixelLayout::Gray;
+        else if (pix_fmt == "bgr24") pixel_layout = PixelLayout::BGR;
+        else if (pix_fmt == "yuv420p") pixel_layout = PixelLayout::I420;
+        else if (pix_fmt == "nv12") pixel_layout = PixelLayout::NV12;
+        else if (pix_fmt == "nv21") pixel_layout = PixelLayout::NV21;
+        else {
+            error = "ֵ֧ظʽ" + pix_fmt;
+            return false;
+        }
+        bool subsampled = pixel_layout != PixelLayout::Gray && pixel_layout != PixelLayout::BGR;
+        if (width <= 0 || height <= 0 || (subsampled && (width % 2 || height % 2))) {
+            error = "Ч֡ߴ磺" + std::to_string(width) + "x" + std::to_string(height);
+            return false;
+        }
+        return true;
+    }
+
+    std::FILE* file = nullptr;               // 
+    bool y4m = false;                        // ǷΪY4Mʽ
+    int width = 0;                           // ֡
+    int height = 0;                          // ֡߶
+    double frame_rate = 30;                  // ֡ʣrawvideoδָʱΪ30
+    PixelLayout pixel_layout = PixelLayout::Gray; // Ų
+    cv::Mat buffer;                          // õ֡
+    size_t frame_bytes = 0;                  // һֽ֡
+};
+
+/**
+ * @brief ӹܵ밴̶ɿƺļӿ FrameSampler ͬ
+ *
+ * ֻܵ˳ȡҪ֡ͬһöȡĻ
+ * ڶȡһ֮֡ǰꡣ
+ */
+class RawFrameSampler {
+public:
+/**
+ * @brief 캯
+ *
+ * @param reader Ѵ򿪵Ķȡ
+ * @param start_frame ʼ֡
+ * @param end_frame ֡볤δ֪ʱΪ INT_MAX
+ * @param frame_skip ֡
+ */
+    RawFrameSampler(RawFrameReader& reader, int start_frame, int end_frame, int frame_skip)
+        : reader(reader), end_frame(end_frame), frame_skip(std::max(1, frame_skip)), frame_index(start_frame) {}
+
+    // òƺÿ֡ãм㲢дϣһ
+    void set_step_controller(std::function<int(SampledFrame&)> controller) { step_controller = std::move(controller); }
+
+/**
+ * @brief ȡһ֡
+ *
+ * @param sample 
+ * @return bool ѵ֡ʱ false
+ */
+    bool next(SampledFrame& sample) {
+        if (finished || frame_index >= end_frame) return false;
+        bool skipped = true;
+        for (; position < frame_index && skipped; ++position) skipped = reader.skip();
+        if (!skipped || !reader.read(sample.frame)) {
+            finished = true;
+            return false;
+        }
+        ++position;
+        sample.layout = reader.layout();
+        sample.frame_index = frame_index;
+        sample.position = position;
+        sample.timestamp = frame_index * 1000.0 / reader.fps();
+        sample.hashed = false;
+
+        int step = step_controller ? std::max(1, step_controller(sample)) : frame_skip;
+        frame_index += step;
+        return true;
+    }
+
+private:
+    RawFrameReader& reader;
+    const int end_frame;   // ֡
+    const int frame_skip;  // ֡
+    int frame_index;       // һ֡
+    int position = 0;      // һȡ֡
+    bool finished = false; // Ƿѽ
+    std::function<int(SampledFrame&)> step_controller; // ƺΪ
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "persistent_index.hpp"
+
+class SlideIndex;
+
+/**
+ * @brief SlideIndex::find_or_claim õһ滭ĵǼǡ
+ *
+ * ͼƬд commit Ǽǣδ commit תдͼƬʱ׳쳣ʱǼǣ
+ * ȴû漴һֱȴȥ
+ */
+class SlideClaim {
+public:
+    SlideClaim() = default;
+    SlideClaim(const SlideClaim&) = delete;
+    SlideClaim& operator=(const SlideClaim&) = delete;
+    ~SlideClaim() { commit(false, std::string(), 0, std::string()); }
+
+/**
+ * @brief ǼǣͼƬдɹʱûеǼʱκ¡
+ *
+ * @param saved ͼƬǷдɹ
+ * @param source ԴƵ
+ * @param timestamp ʾʱms
+ * @param output_path ͼƬ·
+ */
+    inline void commit(bool saved, const std::string& source, double timestamp, const std::string& output_path);
+
+private:
+    friend class SlideIndex;
+    SlideIndex* index = nullptr; // ǼڵûеǼʱΪ
+    FrameHash hash;              // ǼǵĹϣֵ
+};
+
+/**
+ * @brief γ̹õѱ滭ȡλͬʱУͬһϣļ
+ *
+ * µĻȵǼΪ棬ͼƬдɹżе·ָеļ
+ * 滭Ƶ֡ʱȴ䱣ɣƵͬʱͬһ»õƬʱֻһᱣ档
+ * еǼǵֻдͼƬٵȴǼǣ˲ụȴס
+ */
+class SlideIndex {
+public:
+/**
+ * @brief ļʱ PersistentIndex::open
+ */
+    bool open(const std::string& path, const IndexFormat& format, HashDistance distance, const std::vector<int>& words,
+              std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->distance = distance;
+        return index.open(path, format, distance, words, error);
+    }
+
+/**
+ * @brief  hash Ƶѱ滭档
+ *
+ * @param hash ϣֵ
+ * @param threshold ƶȱȽֵ
+ * @param existing ƻʱԴ
+ * @return bool Ƿƻ
+ */
+    bool find(const FrameHash& hash, int threshold, IndexEntry& existing) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        int id = index.find_within(hash, threshold);
+        if (id < 0) return false;
+        existing = index.entry(id);
+        return true;
+    }
+
+/**
+ * @brief  hash Ƶѱ滭棬ûʱѱ֡ǼΪ档
+ *
+ * ƵĴ滭ʱȵȴ false ʱ֡ĵǼǼ claim УдͼƬ claim.commit 
+ *
+ * @param hash ϣֵ
+ * @param threshold ƶȱȽֵ
+ * @param existing ƻʱԴ
+ * @param claim ûƻʱ֡ĵǼǣǰܳǼǣ
+ * @return bool Ƿƻ
+ */
+    bool find_or_claim(const FrameHash& hash, int threshold, IndexEntry& existing, SlideClaim& claim) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto similar = [&](const FrameHash& claimed) { return distance(claimed, hash) < threshold; };
+        changed.wait(lock, [&] { return std::none_of(claims.begin(), claims.end(), similar); });
+        int id = index.find_within(hash, threshold);
+        if (id >= 0) {
+            existing = index.entry(id);
+            return true;
+        }
+        claims.push_back(hash);
+        claim.index = this;
+        claim.hash = hash;
+        return false;
+    }
+
+    // ѱĻ
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return index.size();
+    }
+
+private:
+    friend class SlideClaim;
+
+    // һǼǣ SlideClaim::commit
+    void release(const FrameHash& hash, bool saved, const std::string& source, double timestamp,
+                 const std::string& output_path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (saved && !index.append(hash, source, timestamp, output_path)) std::cerr << "޷дϣ" << std::endl;
+            auto claimed = std::find(claims.begin(), claims.end(), hash);
+            if (claimed != claims.end()) claims.erase(claimed);
+        }
+        changed.notify_all();
+    }
+
+    mutable std::mutex mutex;                 // ͵Ǽ
+    std::condition_variable changed;          // Ǽǽʱ֪ͨ
+    PersistentIndex index;                    // ϣļ
+    std::vector<FrameHash> claims;            // ѵǼǡδдͼƬĻ
+    HashDistance distance;                    // ϣ
+};
+
+inline void SlideClaim::commit(bool saved, const std::string& source, double timestamp, const std::string& output_path) {
+    if (!index) return;
+    SlideIndex* claimed = index;
+    index = nullptr;
+    claimed->release(hash, saved, source, timestamp, output_path);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "hash_region.hpp"
+#include "hash_value.hpp"
+#include "kernels.hpp"
+
+// ָϣÿλ44ֵ HashKernels::tile_hash
+constexpr int tile_hash_bits = 16;
+
+// һ FrameHash ɵĸ
+constexpr int max_tiles = FrameHash::bits / tile_hash_bits;
+
+/**
+ * @brief ָϣľ룺ֵɰCPUѡں˼㣩
+ *
+ * ƶȱȽֵΪÿֵһı仯ֵΪ֡ͬ
+ * δʹõĸ඼Ϊ0Ӱ
+ *
+ * @param a ָϣ
+ * @param b ָϣ
+ * @return int 仯һĺ
+ */
+inline int tile_distance(const FrameHash& a, const FrameHash& b) {
+    return cpu_kernels().tile_distance(a.words.data(), b.words.data());
+}
+
+/**
+ * @brief ָϣѻ棨ROIΪ rowscols ÿ񵥶С16λϣ
+ * ˳ FrameHash i ռ 16i  16i+15 λ
+ *
+ *  cv::parallel_for_ м㣬֡ȻֻȡһΡų򰴸ֱӳ䡣
+ */
+class TileHasher {
+public:
+    TileHasher() = default;
+
+/**
+ * @brief 캯
+ *
+ * @param frame_size ߴ
+ * @param roi ָΪʱʹ
+ * @param exclusions ųľΣ꣩
+ * @param mask ͼ0 ʾųΪ
+ * @param rows 
+ * @param cols rows  cols  max_tiles
+ */
+    TileHasher(cv::Size frame_size, const cv::Rect& roi, const std::vector<cv::Rect>& exclusions, const cv::Mat& mask,
+               int rows, int cols) {
+        CV_Assert(rows > 0 && cols > 0 && rows * cols <= max_tiles);
+        cv::Rect frame(cv::Point(0, 0), frame_size);
+        cv::Rect area = roi.empty() ? frame : (roi & frame);
+        if (area.empty()) area = frame;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                int x = area.x + c * area.width / cols, y = area.y + r * area.height / rows;
+                cv::Rect cell(x, y, area.x + (c + 1) * area.width / cols - x, area.y + (r + 1) * area.height / rows - y);
+                cells.emplace_back(frame_size, cell, exclusions, mask);
+            }
+        }
+    }
+
+    // Ƿ÷ָ
+    bool empty() const { return cells.empty(); }
+
+/**
+ * @brief ָϣ
+ *
+ * @param raw 
+ * @param layout Ų
+ * @return FrameHash ϣ
+ */
+    FrameHash hash(const cv::Mat& raw, PixelLayout layout) const {
+        uint16_t tiles[max_tiles] = {};
+        const HashKernels& kernels = cpu_kernels();
+        cv::parallel_for_(cv::Range(0, int(cells.size())), [&](const cv::Range& range) {
+            float thumbnail[thumbnail_size * thumbnail_size];
+            for (int i = range.start; i < range.end; ++i) {
+                cells[i].make_thumbnail(raw, layout, thumbnail);
+                tiles[i] = kernels.tile_hash(thumbnail); // 44ֵ뱾λȽ
+            }
+        });
+
+        FrameHash hash;
+        constexpr int per_word = 64 / tile_hash_bits;
+        for (int i = 0; i < int(cells.size()); ++i) {
+            hash.words[i / per_word] |= uint64_t(tiles[i]) << (64 - tile_hash_bits * (i % per_word + 1));
+        }
+        return hash;
+    }
+
+private:
+    std::vector<HashRegion> cells; // 
+};
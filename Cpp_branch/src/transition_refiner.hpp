@@ -0,0 +1,128 @@
+#pragma once
+
+#include <opencv2/videoio.hpp>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "frame_sampler.hpp"
+
+/**
+ * @brief ҳλϸֲ֡ʱֶ֮λҵ»ĵһ֡
+ *
+ * ֹ˶ơڶʱڱȶĻ棬˵δֲ֮仹һҳ
+ * ͬᱻҳͼȶĻ棬ʱλȡ»ĵһ֡
+ * ˿ʹúܴĴֲҳ
+ */
+class TransitionRefiner {
+public:
+/**
+ * @brief 캯
+ *
+ * @param cap õƵֻڽ߳ʹã
+ * @param hasher ֡ϣĺ
+ * @param distance ϣֵĺ
+ * @param threshold ƶȱȽֵ
+ * @param settle_frames жϻȶʱ֡
+ */
+    TransitionRefiner(cv::VideoCapture& cap, std::function<FrameHash(const SampledFrame&)> hasher,
+                      std::function<int(const FrameHash&, const FrameHash&)> distance, int threshold, int settle_frames)
+        : cap(cap), hasher(std::move(hasher)), distance(std::move(distance)), threshold(threshold),
+          settle_frames(std::max(1, settle_frames)) {}
+
+/**
+ * @brief һֲ֡ϸĲʱ˳׷ӵ outһǸ֡
+ *
+ * @param sample ֲ֡
+ * @param out Ĳ
+ */
+    void refine(SampledFrame sample, std::vector<SampledFrame>& out) {
+        if (!sample.hashed) {
+            sample.hash = hasher(sample);
+            sample.hashed = true;
+        }
+        layout = sample.layout;
+
+        Point current{sample.frame_index, sample.hash, sample.timestamp};
+        if (has_prev && current.index - prev.index > 1 && distance(prev.hash, current.hash) >= threshold) {
+            Point first = bisect(prev, current, out);
+            sample.position = first.index + 1; // ʱλȡ»ĵһ֡
+            sample.timestamp = first.msec;
+        }
+        prev = current;
+        has_prev = true;
+        out.push_back(std::move(sample));
+    }
+
+private:
+    // Ķ˵
+    struct Point {
+        int index;      // ֡
+        FrameHash hash; // ϣֵ
+        double msec;    // ʱms
+    };
+
+    // λָ֡
+    bool decode(int frame_index, SampledFrame& sample) {
+        cap.set(cv::CAP_PROP_POS_FRAMES, frame_index);
+        if (!cap.grab() || !cap.retrieve(sample.frame)) return false;
+        sample.layout = layout;
+        sample.frame_index = frame_index;
+        sample.position = frame_index + 1;
+        sample.timestamp = cap.get(cv::CAP_PROP_POS_MSEC);
+        sample.hash = hasher(sample);
+        sample.hashed = true;
+        return true;
+    }
+
+/**
+ * @brief  (lo, hi] жֲ hi ĵһ֡;зֵȶм仭水˳׷ӵ out
+ *
+ * @param lo ɻһ֡
+ * @param hi »һ֡
+ * @param out м仭
+ * @return Point »ĵһ֡
+ */
+    Point bisect(Point lo, Point hi, std::vector<SampledFrame>& out) {
+        while (hi.index - lo.index > 1) {
+            int mid = lo.index + (hi.index - lo.index) / 2;
+            SampledFrame middle;
+            if (!decode(mid, middle)) break;
+
+            Point found{mid, middle.hash, middle.timestamp};
+            if (distance(lo.hash, middle.hash) < threshold) {
+                lo = found;  // Ǿɻ
+            } else if (distance(middle.hash, hi.hash) < threshold) {
+                hi = found;  // »
+            } else {
+                // ˶ͬҳû㣬ȶʱΪһҳ
+                Point first = bisect(lo, found, out);
+                if (is_settled(found, hi.index)) {
+                    middle.position = first.index + 1;
+                    middle.timestamp = first.msec;
+                    out.push_back(std::move(middle));
+                }
+                lo = found;
+            }
+        }
+        return hi;
+    }
+
+    // 黭֮ settle_frames ֡Ƿ񱣳ֲ䣨 limit
+    bool is_settled(Point point, int limit) {
+        int check = std::min(point.index + settle_frames, limit - 1);
+        if (check <= point.index) return false;
+        SampledFrame later;
+        if (!decode(check, later)) return false;
+        return distance(point.hash, later.hash) < threshold;
+    }
+
+    cv::VideoCapture& cap;
+    std::function<FrameHash(const SampledFrame&)> hasher;            // ϣ
+    std::function<int(const FrameHash&, const FrameHash&)> distance; // ϣ뺯
+    const int threshold;                                             // ƶȱȽֵ
+    const int settle_frames;                                         // ȶԼ֡
+    PixelLayout layout = PixelLayout::BGR;                           // Ų
+    Point prev{0, FrameHash(), 0};                                   // һֲ֡
+    bool has_prev = false;                                           // Ƿһֲ֡
+};
@@ -0,0 +1,161 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+
+#include "change_filter.hpp"
+#include "hash_list.hpp"
+#include "phash.hpp"
+
+using namespace std;
+using namespace cv;
+
+// вƽʱus
+double time_us(int iterations, const function<void(int)>& body) {
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    chrono::duration<double, micro> elapsed = chrono::high_resolution_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+// PPTҳĲ֡׵ס֣
+Mat make_slide(int width, int height, int page) {
+    Mat slide(height, width, CV_8UC3, Scalar(255, 255, 255));
+    rectangle(slide, Rect(0, 0, width, height / 8), Scalar(120, 60, 20), FILLED);
+    for (int line = 0; line < 8; ++line) {
+        putText(slide, "Page " + to_string(page) + " line " + to_string(line) + " lorem ipsum dolor sit amet",
+                Point(width / 12, height / 4 + line * height / 12), FONT_HERSHEY_SIMPLEX, height / 720.0, Scalar(0, 0, 0), 2);
+    }
+    return slide;
+}
+
+// ԭʵ֣˫СתҶȡ32x32 DCTΪ
+size_t reference_pHash(const Mat& img) {
+    Mat resized, gray, gray_float, dct_result;
+    resize(img, resized, Size(32, 32));
+    cvtColor(resized, gray, COLOR_BGR2GRAY);
+    gray.convertTo(gray_float, CV_64F);
+    dct(gray_float, dct_result);
+    Mat dct_roi = dct_result(Rect(0, 0, 8, 8));
+    double mean = cv::mean(dct_roi)[0];
+    size_t hash = 0;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            hash = (hash << 1) | (dct_roi.at<double>(i, j) > mean ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+int main() {
+    const int frame_iterations = 200;    // ֡ԵĴ
+    const int hash_iterations = 200000;  // ͼϣԵĴ
+
+    Mat frame = make_slide(1920, 1080, 1);
+    Mat yuv;
+    cvtColor(frame, yuv, COLOR_BGR2YUV_I420);
+
+    size_t sink = 0; // ֹŻ
+    cout << fixed << setprecision(3);
+    cout << "1080p ԭʵ֣resize + cvtColor + dct"
+         << time_us(frame_iterations, [&](int) { sink += reference_pHash(frame); }) << " us" << endl;
+
+    float thumbnail[thumbnail_size * thumbnail_size];
+    cout << "1080p BGR ͼ"
+         << time_us(frame_iterations, [&](int) { make_thumbnail(frame, PixelLayout::BGR, thumbnail); }) << " us" << endl;
+    cout << "1080p I420 ͼ"
+         << time_us(frame_iterations, [&](int) { make_thumbnail(yuv, PixelLayout::I420, thumbnail); }) << " us" << endl;
+    float chroma[thumbnail_size * thumbnail_size];
+    cout << "1080p BGR ͼ+ɫͼ"
+         << time_us(frame_iterations, [&](int) { make_thumbnail(frame, PixelLayout::BGR, thumbnail, Rect(), chroma); }) << " us"
+         << endl;
+    cout << "1080p I420 ͼ+ɫͼ"
+         << time_us(frame_iterations, [&](int) { make_thumbnail(yuv, PixelLayout::I420, thumbnail, Rect(), chroma); }) << " us"
+         << endl;
+    float tiny[tiny_rows * tiny_cols];
+    cout << "1080p I420 Ԥɸͼ"
+         << time_us(frame_iterations, [&](int) { tiny_thumbnail(yuv, PixelLayout::I420, Rect(), tiny); }) << " us" << endl;
+
+    // 㷨λͬһͼ㣬ÿθĶһر
+    float other[thumbnail_size * thumbnail_size];
+    make_thumbnail(make_slide(1920, 1080, 2), PixelLayout::BGR, other);
+    for (int bits : {64, 128, 256}) {
+        for (HashKind kind : {HashKind::AHash, HashKind::DHash, HashKind::PHash, HashKind::BlockMean, HashKind::Haar}) {
+            HashFunction hasher = hash_function(kind, bits);
+            make_thumbnail(frame, PixelLayout::BGR, thumbnail);
+            // ҳǰĹϣ룬ڱȽϸ㷨
+            int distance = hamming_distance(hasher(thumbnail), hasher(other));
+            double cost = time_us(hash_iterations, [&](int i) {
+                thumbnail[i % (thumbnail_size * thumbnail_size)] += 1;
+                sink += hasher(thumbnail).words[0];
+            });
+            cout << setw(3) << bits << " λ " << setw(10) << hash_kind_name(kind) << "" << cost << " usҳĺ룺"
+                 << distance << endl;
+        }
+    }
+
+    // pHashṹ飩żԱ
+    const int batch_size = 64;
+    ThumbnailBatch batch(batch_size);
+    for (int i = 0; i < batch_size; ++i) {
+        thumbnail[i] += 1;
+        batch.add(thumbnail);
+    }
+    FrameHash hashes[batch_size];
+    for (int bits : {64, 128, 256}) {
+        double cost = time_us(hash_iterations / batch_size, [&](int) {
+            hash_batch(batch, HashKind::PHash, bits, hashes);
+            sink += hashes[0].words[0];
+        });
+        cout << setw(3) << bits << " λ phash" << cost / batch_size << " us/֡" << endl;
+    }
+
+    // ָں˶ԱȣĬʹߵһ飬û PV2I_KERNELS ָ
+    cout << "ǰʹõںˣ" << cpu_kernels().name << endl;
+    const float bgr_weights[3] = {0.114f, 0.587f, 0.299f};
+    // ѱĹϣ϶ʱĲңֵΪ0ɨ飻64λϣÿֻһ֣256λĶԱ
+    const int kept_count = 10000;
+    HashList kept(1), kept_wide;
+    RNG rng(1);
+    for (int i = 0; i < kept_count; ++i) {
+        FrameHash hash;
+        for (auto& word : hash.words) word = (uint64_t(rng.next()) << 32) | rng.next();
+        kept_wide.push_back(hash);
+        hash.words[1] = hash.words[2] = hash.words[3] = 0;
+        kept.push_back(hash);
+    }
+    for (const HashKernels* kernels : available_kernels()) {
+        double area = time_us(frame_iterations, [&](int) {
+            kernels->area_thumbnail(frame.data, frame.step, frame.cols, frame.rows, 3, bgr_weights, thumbnail, nullptr);
+        });
+        FrameHash hash;
+        auto phash = kernels->hash[int(HashKind::PHash)][hash_width_index(64)];
+        double single = time_us(hash_iterations, [&](int i) {
+            thumbnail[i % (thumbnail_size * thumbnail_size)] += 1;
+            phash(thumbnail, hash.words.data());
+            sink += hash.words[0];
+        });
+        double batched = time_us(hash_iterations / batch_size, [&](int) {
+            kernels->phash_batch[hash_width_index(64)](batch.pixel(0), batch.pixel_stride(), batch.size(), hashes[0].words.data());
+            sink += hashes[0].words[0];
+        });
+        double hamming = time_us(hash_iterations, [&](int i) {
+            sink += kernels->hamming_distance[hash_width_index(64)](hashes[i % batch_size].words.data(), hash.words.data());
+        });
+        double scan = time_us(frame_iterations, [&](int i) {
+            sink += kernels->find_within[hash_width_index(64)](kept.data(0), kept_count, hashes[i % batch_size].words.data(), 0);
+        });
+        double scan_wide = time_us(frame_iterations, [&](int i) {
+            sink += kernels->find_within[hash_width_index(256)](kept_wide.data(0), kept_count, hashes[i % batch_size].words.data(), 0);
+        });
+        cout << setw(8) << kernels->name << "BGR ͼ " << area << " us64 λ phash " << single << " us "
+             << batched / batch_size << " us/֡ " << hamming * 1000 << " nsɨ " << kept_count << " ϣ "
+             << scan << " us256 λ " << scan_wide << " us" << endl;
+    }
+
+    cout << "(" << sink % 2 << ")" << endl;
+    return 0;
+}
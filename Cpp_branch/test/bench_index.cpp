@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "bk_tree.hpp"
+#include "hash_list.hpp"
+#include "multi_index.hpp"
+#include "persistent_index.hpp"
+#include "tile_hash.hpp"
+
+using namespace std;
+
+// вƽʱus
+double time_us(int iterations, const function<void(int)>& body) {
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    chrono::duration<double, micro> elapsed = chrono::high_resolution_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+// 64λϣλΪ064λpHashͬ
+FrameHash random_hash(mt19937_64& rng) {
+    FrameHash hash;
+    hash.words[0] = rng();
+    return hash;
+}
+
+// ѹϣתλģͬһҳظ
+FrameHash flip_bits(FrameHash hash, int bits, mt19937_64& rng) {
+    for (int i = 0; i < bits; ++i) hash.words[0] ^= uint64_t(1) << (rng() % 64);
+    return hash;
+}
+
+int main() {
+    const int queries = 200;       // ÿֹģĲѯ
+    const int threshold = 4;       // ƶȱȽֵ
+    const int max_tree_size = 1000000; // BKֻ⵽ǧʱҪʮ룩
+
+    mt19937_64 rng(1);
+    size_t sink = 0; // ֹŻ
+    cout << fixed << setprecision(3);
+    cout << "64 λϣֵ " << threshold << "δУѯйϣƣųȫУѯΪĳϣת2λ" << endl;
+
+    // ѱϣһǧһǧÿֽṹֱͬʱռڴ
+    for (int count = 1000; count <= 10000000; count *= 10) {
+        vector<FrameHash> misses, hits;
+        for (int i = 0; i < queries; ++i) misses.push_back(random_hash(rng));
+
+        cout << setw(8) << count << " " << endl;
+        {
+            HashList list(1);
+            mt19937_64 data(count);
+            for (int i = 0; i < count; ++i) list.push_back(random_hash(data));
+            for (int i = 0; i < queries; ++i) hits.push_back(flip_bits(list[rng() % count], 2, rng));
+            double miss = time_us(queries, [&](int i) { sink += list.find_within(misses[i], threshold); });
+            double hit = time_us(queries, [&](int i) { sink += list.find_within(hits[i], threshold); });
+            cout << "  ˳ɨ裺δ " << miss << " us " << hit << " us" << endl;
+        }
+        if (count <= max_tree_size) {
+            BKTree tree(HashDistance::hamming(1));
+            mt19937_64 data(count);
+            auto start = chrono::high_resolution_clock::now();
+            tree.reserve(count);
+            for (int i = 0; i < count; ++i) tree.insert(random_hash(data));
+            chrono::duration<double> build = chrono::high_resolution_clock::now() - start;
+            double miss = time_us(queries, [&](int i) { sink += tree.find_within(misses[i], threshold); });
+            double hit = time_us(queries, [&](int i) { sink += tree.find_within(hits[i], threshold); });
+            cout << "  BK " << build.count() << " sδ " << miss << " us " << hit << " us" << endl;
+        }
+        {
+            MultiIndex multi({0});
+            mt19937_64 data(count);
+            auto start = chrono::high_resolution_clock::now();
+            multi.reserve(count);
+            for (int i = 0; i < count; ++i) multi.insert(random_hash(data));
+            chrono::duration<double> build = chrono::high_resolution_clock::now() - start;
+            double miss = time_us(queries, [&](int i) { sink += multi.find_within(misses[i], threshold); });
+            double hit = time_us(queries, [&](int i) { sink += multi.find_within(hits[i], threshold); });
+            double wide = time_us(queries, [&](int i) { sink += multi.find_within(misses[i], threshold * 2); });
+            cout << "  ϣ " << build.count() << " sδ " << miss << " us " << hit << " usֵ "
+                 << threshold * 2 << " ʱδ " << wide << " us" << endl;
+        }
+    }
+
+    // ָ루ֵܰӴֻ֣˳ʹBK
+    for (int count : {1000, 10000, 100000}) {
+        HashDistance tiles = HashDistance::tiles();
+        HashList list;
+        BKTree tree(tiles);
+        for (int i = 0; i < count; ++i) {
+            FrameHash hash;
+            for (auto& word : hash.words) word = rng();
+            list.push_back(hash);
+            tree.insert(hash);
+        }
+        FrameHash query;
+        double linear = time_us(queries, [&](int) {
+            for (auto& word : query.words) word = rng();
+            for (size_t j = 0; j < list.size(); ++j) {
+                if (tiles(list.data(j), query.words.data()) < 2) break;
+            }
+        });
+        double bk = time_us(queries, [&](int) {
+            for (auto& word : query.words) word = rng();
+            sink += tree.find_within(query, 2);
+        });
+        cout << setw(8) << count << " ָϣֵ2˳ " << linear << " usBK " << bk << " us" << endl;
+    }
+
+    // ϣļʱֻӳļͷ¼޹أ״βѯʱõҳ
+    {
+        const int count = 1000000;
+        const string path = "bench_index.bin";
+        std::remove(path.c_str());
+        std::remove((path + ".txt").c_str());
+        IndexFormat format;
+        format.hash_bits = 64;
+        string error;
+        PersistentIndex index;
+        if (!index.open(path, format, HashDistance::hamming(1), {0}, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        mt19937_64 data(count);
+        auto start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; ++i) index.append(random_hash(data), "lecture.mp4", i * 1000.0, "frame.jpg");
+        chrono::duration<double> build = chrono::high_resolution_clock::now() - start;
+        index.close();
+
+        start = chrono::high_resolution_clock::now();
+        index.open(path, format, HashDistance::hamming(1), {0}, error);
+        chrono::duration<double, micro> reopen = chrono::high_resolution_clock::now() - start;
+        double first = time_us(1, [&](int) { sink += index.find_within(random_hash(rng), threshold); });
+        double miss = time_us(queries, [&](int) { sink += index.find_within(random_hash(rng), threshold); });
+        cout << setw(8) << count << " ϣļ׷ " << build.count() << " s´ " << reopen.count()
+             << " us״βѯ " << first << " us֮δ " << miss << " us" << endl;
+        index.close();
+        std::remove(path.c_str());
+        std::remove((path + ".txt").c_str());
+    }
+
+    cout << "(" << sink % 2 << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "phash.hpp"
+
+using namespace std;
+
+int failures = 0; // ʧܵļ
+
+// ʱԭ򣨲ֹԱһοȫʧܣ
+void check(bool condition, const string& what) {
+    if (condition) return;
+    failures++;
+    cerr << "ʧܣ" << what << endl;
+}
+
+const HashKind all_kinds[] = {HashKind::AHash, HashKind::DHash, HashKind::PHash, HashKind::BlockMean, HashKind::Haar};
+const int all_bits[] = {64, 128, 256};
+
+// ϣʮƱʾʧԭ
+string hex(const FrameHash& hash) {
+    static const char digits[] = "0123456789abcdef";
+    string text;
+    for (uint64_t word : hash.words) {
+        for (int shift = 60; shift >= 0; shift -= 4) text += digits[(word >> shift) & 15];
+    }
+    return text;
+}
+
+// ɲõͼPPTҳ棨ǳɫס֣ɫ
+vector<vector<float>> make_thumbnails() {
+    mt19937 rng(11);
+    uniform_real_distribution<float> level(0, 255);
+    vector<vector<float>> thumbnails;
+    for (int page = 0; page < 40; ++page) {
+        vector<float> slide(thumbnail_size * thumbnail_size, 230 + float(page % 20));
+        for (int x = 0; x < thumbnail_size; ++x) {
+            for (int y = 0; y < 4; ++y) slide[y * thumbnail_size + x] = 60;
+        }
+        for (int line = 0; line < 6; ++line) {
+            int y = 8 + line * 4, length = 8 + int(rng() % 20);
+            for (int x = 2; x < 2 + length; ++x) slide[y * thumbnail_size + x] = level(rng) / 4;
+        }
+        thumbnails.push_back(slide);
+    }
+    thumbnails.push_back(vector<float>(thumbnail_size * thumbnail_size, 0.0f));
+    thumbnails.push_back(vector<float>(thumbnail_size * thumbnail_size, 128.0f));
+    for (int i = 0; i < 40; ++i) {
+        vector<float> noise(thumbnail_size * thumbnail_size);
+        for (float& value : noise) value = level(rng);
+        thumbnails.push_back(noise);
+    }
+    return thumbnails;
+}
+
+/**
+ * @brief ʵֵpHash˫ȰDCT-II cv::dct ͬϽ rowscols ϵ
+ * ֵȽϡں˵ĽֻϵֵȣܸıȽϽλϲͬ
+ *
+ * @param thumbnail 3232 ͼ
+ * @param bits λ64128  256
+ * @param hash ϣֵ
+ * @param ambiguous ϵֵڽӽȽϵλ
+ */
+void reference_pHash(const float* thumbnail, int bits, FrameHash& hash, FrameHash& ambiguous) {
+    const int n = thumbnail_size;
+    const int rows = bits == 256 ? 16 : 8, cols = bits == 64 ? 8 : 16;
+    const double pi = 3.14159265358979323846;
+    auto basis = [&](int u, int x) { return (u == 0 ? sqrt(1.0 / n) : sqrt(2.0 / n)) * cos(pi * (2 * x + 1) * u / (2 * n)); };
+
+    vector<double> coefficients(bits);
+    double mean = 0, largest = 0;
+    for (int u = 0; u < rows; ++u) {
+        for (int v = 0; v < cols; ++v) {
+            double sum = 0;
+            for (int y = 0; y < n; ++y) {
+                for (int x = 0; x < n; ++x) sum += basis(u, y) * basis(v, x) * thumbnail[y * n + x];
+            }
+            coefficients[u * cols + v] = sum;
+            mean += sum;
+            largest = max(largest, fabs(sum));
+        }
+    }
+    mean /= bits;
+    hash = FrameHash();
+    ambiguous = FrameHash();
+    for (int i = 0; i < bits; ++i) {
+        if (coefficients[i] > mean) hash.set(i);
+        if (fabs(coefficients[i] - mean) <= 1e-4 * max(largest, 1.0)) ambiguous.set(i);
+    }
+}
+
+// ϣֵ ambiguous ֮λǷͬ
+bool same_except(const FrameHash& a, const FrameHash& b, const FrameHash& ambiguous) {
+    for (int w = 0; w < FrameHash::word_count; ++w) {
+        if ((a.words[w] ^ b.words[w]) & ~ambiguous.words[w]) return false;
+    }
+    return true;
+}
+
+// ָpHashʵͬ
+void test_reference_phash(const vector<vector<float>>& thumbnails) {
+    for (const HashKernels* kernels : available_kernels()) {
+        for (int bits : all_bits) {
+            auto phash = kernels->hash[int(HashKind::PHash)][hash_width_index(bits)];
+            for (size_t t = 0; t < thumbnails.size(); ++t) {
+                FrameHash expected, ambiguous, hash;
+                reference_pHash(thumbnails[t].data(), bits, expected, ambiguous);
+                phash(thumbnails[t].data(), hash.words.data());
+                check(same_except(hash, expected, ambiguous), string(kernels->name) + " " + to_string(bits) + " λ phash ʵֲͬ "
+                      + to_string(t) + " ţ" + hex(hash) + " / " + hex(expected));
+            }
+        }
+    }
+}
+
+// 㷨ڸָںнȫͬ
+void test_kernel_tables(const vector<vector<float>>& thumbnails) {
+    const HashKernels& baseline = baseline_kernels();
+    for (const HashKernels* kernels : available_kernels()) {
+        for (HashKind kind : all_kinds) {
+            for (int bits : all_bits) {
+                auto expected_hash = baseline.hash[int(kind)][hash_width_index(bits)];
+                auto hash = kernels->hash[int(kind)][hash_width_index(bits)];
+                for (size_t t = 0; t < thumbnails.size(); ++t) {
+                    FrameHash expected, result;
+                    expected_hash(thumbnails[t].data(), expected.words.data());
+                    hash(thumbnails[t].data(), result.words.data());
+                    check(result == expected, string(kernels->name) + " " + to_string(bits) + " λ " + hash_kind_name(kind)
+                          + "  baseline ͬ " + to_string(t) + " ţ" + hex(result) + " / " + hex(expected));
+                }
+            }
+        }
+    }
+}
+
+// pHashżĽͬСǲһĩβ
+void test_batch(const vector<vector<float>>& thumbnails) {
+    for (int batch_size : {1, 7, 16, 37}) {
+        ThumbnailBatch batch(batch_size);
+        for (int i = 0; i < batch_size; ++i) batch.add(thumbnails[(i * 5) % thumbnails.size()].data());
+        vector<FrameHash> hashes(batch_size);
+        for (int bits : all_bits) {
+            string what = to_string(bits) + " λ" + to_string(batch_size) + " ";
+            for (const HashKernels* kernels : available_kernels()) {
+                kernels->phash_batch[hash_width_index(bits)](batch.pixel(0), batch.pixel_stride(), batch.size(), hashes[0].words.data());
+                auto phash = kernels->hash[int(HashKind::PHash)][hash_width_index(bits)];
+                for (int i = 0; i < batch_size; ++i) {
+                    FrameHash single;
+                    phash(thumbnails[(i * 5) % thumbnails.size()].data(), single.words.data());
+                    check(hashes[i] == single, string(kernels->name) + " phash_batch ż㲻ͬ" + what + " " + to_string(i) + " ţ");
+                }
+            }
+            for (HashKind kind : all_kinds) {
+                hash_batch(batch, kind, bits, hashes.data());
+                HashFunction hasher = hash_function(kind, bits);
+                for (int i = 0; i < batch_size; ++i) {
+                    check(hashes[i] == hasher(thumbnails[(i * 5) % thumbnails.size()].data()),
+                          string("hash_batch ") + hash_kind_name(kind) + " ż㲻ͬ" + what + " " + to_string(i) + " ţ");
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    vector<vector<float>> thumbnails = make_thumbnails();
+    test_reference_phash(thumbnails);
+    test_kernel_tables(thumbnails);
+    test_batch(thumbnails);
+    if (failures > 0) {
+        cerr << failures << " ʧ" << endl;
+        return 1;
+    }
+    cout << "ȫͨںˣ";
+    for (const HashKernels* kernels : available_kernels()) cout << " " << kernels->name;
+    cout << "" << endl;
+    return 0;
+}
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bk_tree.hpp"
+#include "hash_list.hpp"
+#include "multi_index.hpp"
+#include "persistent_index.hpp"
+#include "tile_hash.hpp"
+
+using namespace std;
+
+int failures = 0; // ʧܵļ
+
+// ʱԭ򣨲ֹԱһοȫʧܣ
+void check(bool condition, const string& what) {
+    if (condition) return;
+    failures++;
+    cerr << "ʧܣ" << what << endl;
+}
+
+// ں˼ĺ룬Ϊָں˵Ĳ
+int reference_hamming(const FrameHash& a, const FrameHash& b) {
+    int distance = 0;
+    for (int i = 0; i < FrameHash::word_count; ++i) distance += __builtin_popcountll(a.words[i] ^ b.words[i]);
+    return distance;
+}
+
+// ں˼ķָ루16λĺֵ
+int reference_tile(const FrameHash& a, const FrameHash& b) {
+    int largest = 0;
+    for (int tile = 0; tile < max_tiles; ++tile) {
+        int shift = 48 - tile % 4 * tile_hash_bits;
+        uint64_t differ = (a.words[tile / 4] ^ b.words[tile / 4]) >> shift & 0xFFFF;
+        largest = max(largest, __builtin_popcountll(differ));
+    }
+    return largest;
+}
+
+// ϣֻǰ words ֣϶̵ĹϣչΪ FrameHash ʱͬ
+FrameHash random_hash(mt19937_64& rng, int words) {
+    FrameHash hash;
+    for (int i = 0; i < words; ++i) hash.words[i] = rng();
+    return hash;
+}
+
+// ѹϣǰ bits λת flips λģͬһҳظ
+FrameHash flip_bits(FrameHash hash, int flips, int bits, mt19937_64& rng) {
+    for (int i = 0; i < flips; ++i) {
+        int bit = int(rng() % bits);
+        hash.words[bit / 64] ^= uint64_t(1) << (bit % 64);
+    }
+    return hash;
+}
+
+// ɲѯһΪйϣת0 max_flips λΪϣ
+vector<FrameHash> make_queries(const vector<FrameHash>& hashes, int words, int max_flips, mt19937_64& rng) {
+    vector<FrameHash> queries;
+    for (int i = 0; i < 300; ++i) {
+        if (i % 3 == 2) {
+            queries.push_back(random_hash(rng, words));
+        } else {
+            queries.push_back(flip_bits(hashes[rng() % hashes.size()], int(rng() % (max_flips + 1)), words * 64, rng));
+        }
+    }
+    return queries;
+}
+
+// ʵֵľ
+using ReferenceDistance = int (*)(const FrameHash&, const FrameHash&);
+
+// ˳Ƚϵõ벻 radius ȫ
+vector<int> linear_query(const vector<FrameHash>& hashes, const FrameHash& query, int radius, ReferenceDistance distance) {
+    vector<int> result;
+    for (int id = 0; id < int(hashes.size()); ++id) {
+        if (distance(hashes[id], query) <= radius) result.push_back(id);
+    }
+    return result;
+}
+
+//  find_within ĽƵĹϣʱ֮һûʱ -1
+void check_found(int found, const vector<int>& expected, const string& what) {
+    if (expected.empty()) {
+        check(found == -1, what + "Ӧҵ " + to_string(found));
+    } else {
+        check(binary_search(expected.begin(), expected.end(), found), what + "ӦҵƵĹϣ " + to_string(found));
+    }
+}
+
+// ָľ find_within ںˣʵֵĽȽ
+void test_kernels() {
+    mt19937_64 rng(21);
+    for (const HashKernels* kernels : available_kernels()) {
+        string name = kernels->name;
+        for (int i = 0; i < 2000; ++i) {
+            FrameHash a = random_hash(rng, 4), b = flip_bits(a, int(rng() % 80), 256, rng);
+            check(kernels->tile_distance(a.words.data(), b.words.data()) == reference_tile(a, b), name + " tile_distance");
+            // խںֻȽǰ֣ʵ֮Ϊ0
+            for (int words : {1, 2, 4}) {
+                FrameHash narrow_a = a, narrow_b = b;
+                for (int w = words; w < FrameHash::word_count; ++w) narrow_a.words[w] = narrow_b.words[w] = 0;
+                int distance = kernels->hamming_distance[hash_width_index(words * 64)](a.words.data(), b.words.data());
+                check(distance == reference_hamming(narrow_a, narrow_b), name + " hamming_distance" + to_string(words * 64) + " λ");
+            }
+        }
+
+        // ȵĩβһĲ
+        for (int words : {1, 2, 4}) {
+            HashList list(words);
+            vector<FrameHash> hashes;
+            for (int i = 0; i < 1003; ++i) {
+                hashes.push_back(random_hash(rng, words));
+                list.push_back(hashes.back());
+            }
+            for (const auto& query : make_queries(hashes, words, 12, rng)) {
+                for (int threshold : {1, 4, 8, 13}) {
+                    int expected = -1;
+                    for (int id = 0; id < int(hashes.size()) && expected < 0; ++id) {
+                        if (reference_hamming(hashes[id], query) < threshold) expected = id;
+                    }
+                    string what = name + " find_within" + to_string(words * 64) + " λֵ " + to_string(threshold) + "";
+                    auto find_within = kernels->find_within[hash_width_index(words * 64)];
+                    check(find_within(list.data(0), int(list.size()), query.words.data(), threshold) == expected, what);
+                    check(list.find_within(query, threshold) == expected, "HashList::" + what);
+                }
+            }
+        }
+    }
+}
+
+// BKͶϣ˳ȽϵĽͬ
+void test_trees() {
+    mt19937_64 rng(22);
+    for (int words : {1, 2, 4}) {
+        vector<FrameHash> hashes;
+        for (int i = 0; i < 5000; ++i) hashes.push_back(random_hash(rng, words));
+        vector<int> table_words;
+        for (int i = 0; i < words; ++i) table_words.push_back(i);
+        BKTree tree(HashDistance::hamming(words));
+        MultiIndex multi(table_words);
+        for (const auto& hash : hashes) {
+            tree.insert(hash);
+            multi.insert(hash);
+        }
+        // 뾶 max_probe_radiusʱϣΪ˳ȽϣҲҪ
+        for (const auto& query : make_queries(hashes, words, 20, rng)) {
+            for (int radius : {0, 3, 7, 12, 20}) {
+                vector<int> expected = linear_query(hashes, query, radius, reference_hamming);
+                string what = to_string(words * 64) + " λ뾶 " + to_string(radius);
+                vector<int> result;
+                tree.query(query, radius, result);
+                sort(result.begin(), result.end());
+                check(result == expected, "BKTree::query" + what + "");
+                result.clear();
+                multi.query(query, radius, result);
+                check(result == expected, "MultiIndex::query" + what + "");
+                check_found(tree.find_within(query, radius + 1), expected, "BKTree::find_within" + what + "");
+                check_found(multi.find_within(query, radius + 1), expected, "MultiIndex::find_within" + what + "");
+            }
+        }
+    }
+
+    // ָ
+    vector<FrameHash> hashes;
+    for (int i = 0; i < 3000; ++i) hashes.push_back(random_hash(rng, 4));
+    BKTree tree(HashDistance::tiles());
+    for (const auto& hash : hashes) tree.insert(hash);
+    for (const auto& query : make_queries(hashes, 4, 6, rng)) {
+        for (int radius : {0, 1, 2, 4}) {
+            vector<int> expected = linear_query(hashes, query, radius, reference_tile);
+            vector<int> result;
+            tree.query(query, radius, result);
+            sort(result.begin(), result.end());
+            string what = "ָ񣬰뾶 " + to_string(radius);
+            check(result == expected, "BKTree::query" + what + "");
+            check_found(tree.find_within(query, radius + 1), expected, "BKTree::find_within" + what + "");
+        }
+    }
+}
+
+// ɾļ·¼
+void remove_index(const string& path) {
+    std::remove(path.c_str());
+    std::remove((path + ".txt").c_str());
+}
+
+// ϣļμӱ´򿪣¼Դѯ䣻Ѵ򿪵ٴδ
+void test_persistent_index() {
+    const string path = "test_index.bin";
+    remove_index(path);
+    mt19937_64 rng(23);
+    string error;
+
+    for (bool tiled : {false, true}) {
+        IndexFormat format;
+        format.hash_bits = tiled ? 256 : 64;
+        format.tile_rows = tiled ? 4 : 0;
+        format.tile_cols = tiled ? 4 : 0;
+        int words = tiled ? 4 : 1;
+        HashDistance distance = tiled ? HashDistance::tiles() : HashDistance::hamming(words);
+        string kind = tiled ? "ָ" : "";
+
+        vector<FrameHash> hashes;
+        {
+            PersistentIndex index;
+            check(index.open(path, format, distance, {0}, error), "½" + kind + "" + error);
+            PersistentIndex second;
+            check(!second.open(path, format, distance, {0}, error), kind + "ѱʱӦܾٴδ");
+            // ʼΪ1024д5000ʱӱ
+            for (int i = 0; i < 5000; ++i) {
+                hashes.push_back(random_hash(rng, words));
+                check(index.append(hashes.back(), "video" + to_string(i % 7) + ".mp4", i * 1000.0, "frame" + to_string(i) + ".jpg"),
+                      kind + "׷ӵ " + to_string(i) + " ");
+            }
+        }
+
+        PersistentIndex index;
+        check(index.open(path, format, distance, {0}, error), "´" + kind + "" + error);
+        check(index.size() == hashes.size(), kind + "´򿪺ļ¼");
+        for (int id = 0; id < int(min(index.size(), hashes.size())); ++id) {
+            IndexEntry entry = index.entry(id);
+            bool same = index[id] == hashes[id] && entry.source == "video" + to_string(id % 7) + ".mp4"
+                && entry.timestamp == id * 1000.0 && entry.output_path == "frame" + to_string(id) + ".jpg";
+            check(same, kind + "´򿪺 " + to_string(id) + " ¼");
+        }
+        ReferenceDistance reference = tiled ? reference_tile : reference_hamming;
+        for (const auto& query : make_queries(hashes, words, tiled ? 4 : 8, rng)) {
+            for (int threshold : {1, 4, 6}) {
+                vector<int> expected = linear_query(hashes, query, threshold - 1, reference);
+                check_found(index.find_within(query, threshold), expected, kind + " find_withinֵ " + to_string(threshold) + "");
+            }
+        }
+
+        IndexFormat other = format;
+        other.hash_bits = 128;
+        PersistentIndex mismatched;
+        index.close();
+        check(!mismatched.open(path, other, distance, {0}, error), kind + "ĸʽͬʱӦܾ");
+        mismatched.close();
+        remove_index(path);
+    }
+}
+
+int main() {
+    test_kernels();
+    test_trees();
+    test_persistent_index();
+    if (failures > 0) {
+        cerr << failures << " ʧ" << endl;
+        return 1;
+    }
+    cout << "ȫͨ" << endl;
+    return 0;
+}